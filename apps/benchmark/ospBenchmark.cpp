@@ -0,0 +1,621 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+/*! \file ospBenchmark.cpp Headless benchmark: renders procedurally
+    generated scenes with a given set of renderers and reports frame
+    times, model build times and memory use as JSON */
+
+// ospray
+#include "ospray/ospray.h"
+#include "ospray/common/OSPCommon.h"
+// std
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace ospray {
+  using std::cout;
+  using std::endl;
+
+  //! benchmark configuration, set from the command line
+  struct Config {
+    Config()
+      : width(1024), height(768), spp(1), numThreads(0),
+        warmupFrames(2), timedFrames(10), scale(1.f),
+        outputFileName("ospBenchmark.json"), writeImages(false)
+    {}
+
+    int width, height, spp, numThreads;
+    int warmupFrames, timedFrames;
+    /*! multiplier for the primitive/voxel counts of all scenes */
+    float scale;
+    std::vector<std::string> scenes;
+    std::vector<std::string> renderers;
+    std::string outputFileName;
+    /*! write the last frame of every run as '<scene>_<renderer>.ppm' */
+    bool writeImages;
+  };
+
+  //! results of rendering one scene with one renderer
+  struct Run {
+    std::string scene, renderer;
+    double sceneSetupTime; //!< creating and committing geometry/volumes
+    double modelCommitTime; //!< committing the model, i.e., building the BVH
+    int64 rssBefore, rssAfterCommit, rssAfterRender; //!< resident set size in bytes
+    int64 rssPeak; //!< peak resident set size during this run in bytes
+    std::vector<double> frameTimes;
+  };
+
+  const char *allScenes[] = { "spheres", "streamlines", "trianglemesh", "volume", "materials" };
+  const char *allRenderers[] = { "raycast", "ao", "obj", "pathtracer", "raycast_volume_renderer" };
+
+  // ------------------------------------------------------------------
+  // helpers
+  // ------------------------------------------------------------------
+
+  /*! small deterministic random number generator, so every platform
+      and every run sees the same scenes */
+  struct Random {
+    Random(uint32 seed) : state(seed) {}
+    float operator()()
+    {
+      state = state * 1664525u + 1013904223u;
+      return (state >> 8) * (1.f / (1 << 24));
+    }
+    uint32 state;
+  };
+
+  //! current resident set size in bytes, 0 if unknown
+  int64 residentSetSize()
+  {
+    long long pages = 0;
+    FILE *file = fopen("/proc/self/statm","r");
+    if (file) {
+      long long size;
+      if (fscanf(file,"%lli %lli",&size,&pages) != 2) pages = 0;
+      fclose(file);
+    }
+    return pages * sysconf(_SC_PAGESIZE);
+  }
+
+  /*! resets the peak resident set size of the process to its current
+      one (Linux 4.0 and later); returns false if that is not possible */
+  bool resetPeakResidentSetSize()
+  {
+    FILE *file = fopen("/proc/self/clear_refs","w");
+    if (!file) return false;
+    const bool written = fputs("5",file) >= 0;
+    return (fclose(file) == 0) && written;
+  }
+
+  //! peak resident set size in bytes since the last reset, or since the process started
+  int64 peakResidentSetSize()
+  {
+    FILE *file = fopen("/proc/self/status","r");
+    if (file) {
+      char line[256];
+      long long kB = -1;
+      while (fgets(line,sizeof(line),file))
+        if (sscanf(line,"VmHWM: %lli kB",&kB) == 1) break;
+      fclose(file);
+      if (kB >= 0) return int64(kB) * 1024;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return int64(usage.ru_maxrss) * 1024;
+#endif
+  }
+
+  void writePPM(const std::string &fileName, int sizeX, int sizeY, const uint32 *pixel)
+  {
+    FILE *file = fopen(fileName.c_str(),"wb");
+    if (!file) return;
+    fprintf(file,"P6\n%i %i\n255\n",sizeX,sizeY);
+    std::vector<unsigned char> out(3*sizeX);
+    for (int y=0;y<sizeY;y++) {
+      const unsigned char *in = (const unsigned char *)&pixel[(sizeY-1-y)*sizeX];
+      for (int x=0;x<sizeX;x++)
+        for (int c=0;c<3;c++)
+          out[3*x+c] = in[4*x+c];
+      fwrite(&out[0],3*sizeX,1,file);
+    }
+    fclose(file);
+  }
+
+  //! renderer-specific material, NULL if the renderer has no materials
+  OSPMaterial newMaterial(OSPRenderer renderer, const std::string &rendererType,
+                          const char *ptType, const vec3f &color)
+  {
+    const bool isPT = rendererType == "pathtracer";
+    OSPMaterial material = ospNewMaterial(renderer,isPT ? ptType : "OBJMaterial");
+    if (!material) return NULL;
+    ospSet3f(material,"Kd",color.x,color.y,color.z);
+    ospSet3f(material,"reflectance",color.x,color.y,color.z);
+    ospSet3f(material,"pigmentColor",color.x,color.y,color.z);
+    ospCommit(material);
+    return material;
+  }
+
+  void setMaterial(OSPGeometry geometry, OSPMaterial material)
+  {
+    if (material) {
+      ospSetMaterial(geometry,material);
+      ospRelease(material);
+    }
+  }
+
+  // ------------------------------------------------------------------
+  // scenes; each one adds its content to the model and returns the
+  // bounds of that content
+  // ------------------------------------------------------------------
+
+  box3f makeSpheres(OSPModel model, OSPRenderer renderer, const std::string &rendererType,
+                    const Config &config)
+  {
+    const size_t numSpheres = std::max(size_t(1),size_t(1000000 * config.scale));
+    const float radius = .5f / powf(numSpheres,1.f/3.f);
+    Random random(1);
+    std::vector<vec3f> center(numSpheres);
+    for (size_t i=0;i<numSpheres;i++)
+      center[i] = vec3f(random(),random(),random());
+
+    OSPGeometry spheres = ospNewGeometry("spheres");
+    OSPData data = ospNewData(numSpheres*3,OSP_FLOAT,&center[0]);
+    ospCommit(data);
+    ospSetData(spheres,"spheres",data);
+    ospRelease(data);
+    ospSet1i(spheres,"bytes_per_sphere",sizeof(vec3f));
+    ospSet1f(spheres,"radius",radius);
+    setMaterial(spheres,newMaterial(renderer,rendererType,"Matte",vec3f(.7f,.3f,.2f)));
+    ospCommit(spheres);
+    ospAddGeometry(model,spheres);
+    ospRelease(spheres);
+    return box3f(vec3f(-radius),vec3f(1.f+radius));
+  }
+
+  box3f makeStreamLines(OSPModel model, OSPRenderer renderer, const std::string &rendererType,
+                        const Config &config)
+  {
+    const int verticesPerLine = 100;
+    const size_t numLines = std::max(size_t(1),size_t(10000 * config.scale));
+    const float radius = .002f;
+    Random random(2);
+    std::vector<vec3fa> vertex;
+    std::vector<int32> index;
+    for (size_t l=0;l<numLines;l++) {
+      // helical lines around random axes
+      const vec3f start(random(),random(),random());
+      const float phase = 2.f*float(M_PI)*random(), turns = 1.f + 3.f*random();
+      const float r = .02f + .05f*random();
+      for (int v=0;v<verticesPerLine;v++) {
+        const float t = v / float(verticesPerLine-1);
+        const float a = phase + 2.f*float(M_PI)*turns*t;
+        if (v > 0) index.push_back(vertex.size()-1);
+        vertex.push_back(vec3fa(start.x + r*cosf(a), start.y + r*sinf(a), start.z + .2f*t - .1f));
+      }
+    }
+
+    OSPGeometry streamLines = ospNewGeometry("streamlines");
+    OSPData data = ospNewData(vertex.size(),OSP_FLOAT3A,&vertex[0]);
+    ospCommit(data);
+    ospSetData(streamLines,"vertex",data);
+    ospRelease(data);
+    data = ospNewData(index.size(),OSP_INT,&index[0]);
+    ospCommit(data);
+    ospSetData(streamLines,"index",data);
+    ospRelease(data);
+    ospSet1f(streamLines,"radius",radius);
+    setMaterial(streamLines,newMaterial(renderer,rendererType,"Plastic",vec3f(.2f,.4f,.8f)));
+    ospCommit(streamLines);
+    ospAddGeometry(model,streamLines);
+    ospRelease(streamLines);
+    return box3f(vec3f(-.1f),vec3f(1.1f));
+  }
+
+  //! adds an n x n heightfield over [0,1]^2 as triangle mesh
+  void addHeightField(OSPModel model, OSPMaterial material, int n, float amplitude)
+  {
+    std::vector<vec3fa> vertex;
+    std::vector<vec3i> index;
+    for (int y=0;y<=n;y++)
+      for (int x=0;x<=n;x++) {
+        const float u = x/float(n), v = y/float(n);
+        const float h = amplitude * (sinf(17.f*u)*cosf(13.f*v) + .3f*sinf(61.f*u+47.f*v));
+        vertex.push_back(vec3fa(u,h,v));
+      }
+    for (int y=0;y<n;y++)
+      for (int x=0;x<n;x++) {
+        const int i = y*(n+1)+x;
+        index.push_back(vec3i(i,i+1,i+n+2));
+        index.push_back(vec3i(i,i+n+2,i+n+1));
+      }
+
+    OSPGeometry mesh = ospNewTriangleMesh();
+    OSPData data = ospNewData(vertex.size(),OSP_FLOAT3A,&vertex[0]);
+    ospCommit(data);
+    ospSetData(mesh,"vertex",data);
+    ospRelease(data);
+    data = ospNewData(index.size(),OSP_INT3,&index[0]);
+    ospCommit(data);
+    ospSetData(mesh,"index",data);
+    ospRelease(data);
+    setMaterial(mesh,material);
+    ospCommit(mesh);
+    ospAddGeometry(model,mesh);
+    ospRelease(mesh);
+  }
+
+  box3f makeTriangleMesh(OSPModel model, OSPRenderer renderer, const std::string &rendererType,
+                         const Config &config)
+  {
+    // 2*n*n triangles, about 2M for scale 1
+    const int n = std::max(1,int(1024 * sqrtf(config.scale)));
+    addHeightField(model,newMaterial(renderer,rendererType,"OBJMaterial",vec3f(.6f)),n,.05f);
+    return box3f(vec3f(0.f,-.1f,0.f),vec3f(1.f,.1f,1.f));
+  }
+
+  box3f makeVolume(OSPModel model, OSPRenderer renderer, const std::string &rendererType,
+                   const Config &config)
+  {
+    const int n = std::max(2,int(256 * powf(config.scale,1.f/3.f)));
+
+    OSPVolume volume = ospNewVolume("block_bricked_volume");
+    ospSetString(volume,"voxelType","float");
+    ospSet3i(volume,"dimensions",n,n,n);
+    ospSet3f(volume,"gridSpacing",1.f/(n-1),1.f/(n-1),1.f/(n-1));
+
+    // nested shells with some high frequency detail, one slice at a time
+    std::vector<float> slice(size_t(n)*n);
+    for (int z=0;z<n;z++) {
+      for (int y=0;y<n;y++)
+        for (int x=0;x<n;x++) {
+          const vec3f p = vec3f(x,y,z) * (2.f/(n-1)) - vec3f(1.f);
+          slice[size_t(y)*n+x] = .5f + .5f*sinf(12.f*length(p)) * cosf(5.f*p.x) * sinf(7.f*p.y+3.f*p.z);
+        }
+      ospSetRegion(volume,&slice[0],osp::vec3i(0,0,z),osp::vec3i(n,n,1));
+    }
+
+    OSPTransferFunction transferFunction = ospNewTransferFunction("piecewise_linear");
+    const vec3f colors[] = { vec3f(0.f,0.f,1.f), vec3f(0.f,1.f,0.f), vec3f(1.f,0.f,0.f) };
+    const float opacities[] = { 0.f, .05f, .3f };
+    OSPData data = ospNewData(3,OSP_FLOAT3,colors);
+    ospCommit(data);
+    ospSetData(transferFunction,"colors",data);
+    ospRelease(data);
+    data = ospNewData(3,OSP_FLOAT,opacities);
+    ospCommit(data);
+    ospSetData(transferFunction,"opacities",data);
+    ospRelease(data);
+    ospSet2f(transferFunction,"valueRange",0.f,1.f);
+    ospCommit(transferFunction);
+
+    ospSetObject(volume,"transferFunction",transferFunction);
+    ospRelease(transferFunction);
+    ospCommit(volume);
+    ospAddVolume(model,volume);
+    ospRelease(volume);
+    return box3f(vec3f(0.f),vec3f(1.f));
+  }
+
+  //! layout of the 'spheres' data of the materials scene
+  struct Sphere {
+    vec3f center;
+    int32 materialID;
+  };
+
+  box3f makeMaterials(OSPModel model, OSPRenderer renderer, const std::string &rendererType,
+                      const Config &config)
+  {
+    // a grid of spheres, each row with a different path tracer material, on a ground plane
+    const char *types[] = { "Matte", "Metal", "Plastic", "Dielectric", "ThinGlass", "MetallicPaint", "Velvet" };
+    const int numTypes = sizeof(types)/sizeof(types[0]);
+    const int perRow = 7;
+
+    std::vector<OSPObject> materials;
+    for (int i=0;i<numTypes;i++) {
+      OSPMaterial material = newMaterial(renderer,rendererType,types[i],
+                                         vec3f(.3f+.1f*i,.9f-.1f*i,.5f));
+      if (material) materials.push_back((OSPObject)material);
+    }
+
+    std::vector<Sphere> sphere;
+    for (int i=0;i<numTypes;i++)
+      for (int j=0;j<perRow;j++) {
+        Sphere s;
+        s.center = vec3f((j+.5f)/perRow,.07f,(i+.5f)/numTypes);
+        s.materialID = i;
+        sphere.push_back(s);
+      }
+
+    OSPGeometry spheres = ospNewGeometry("spheres");
+    OSPData data = ospNewData(sphere.size()*sizeof(Sphere),OSP_UCHAR,&sphere[0]);
+    ospCommit(data);
+    ospSetData(spheres,"spheres",data);
+    ospRelease(data);
+    ospSet1i(spheres,"bytes_per_sphere",sizeof(Sphere));
+    ospSet1f(spheres,"radius",.06f);
+    if (!materials.empty()) {
+      ospSet1i(spheres,"offset_materialID",sizeof(vec3f));
+      // the data array takes over the references to the materials
+      data = ospNewData(materials.size(),OSP_OBJECT,&materials[0]);
+      ospCommit(data);
+      ospSetData(spheres,"materialList",data);
+      ospRelease(data);
+    }
+    ospCommit(spheres);
+    ospAddGeometry(model,spheres);
+    ospRelease(spheres);
+
+    addHeightField(model,newMaterial(renderer,rendererType,"Matte",vec3f(.8f)),
+                   std::max(1,int(64 * sqrtf(config.scale))),.002f);
+    return box3f(vec3f(0.f,0.f,0.f),vec3f(1.f,.15f,1.f));
+  }
+
+  // ------------------------------------------------------------------
+  // benchmark driver
+  // ------------------------------------------------------------------
+
+  /*! whether the given renderer can display the given scene; only the
+      volume renderer shows volumes, and it requires volume content */
+  bool compatible(const std::string &scene, const std::string &renderer)
+  {
+    return (scene == "volume") == (renderer == "raycast_volume_renderer");
+  }
+
+  Run runBenchmark(const std::string &scene, const std::string &rendererType, const Config &config)
+  {
+    Run run;
+    run.scene = scene;
+    run.renderer = rendererType;
+    run.rssBefore = residentSetSize();
+    const bool peakReset = resetPeakResidentSetSize();
+
+    OSPRenderer renderer = ospNewRenderer(rendererType.c_str());
+    if (!renderer)
+      throw std::runtime_error("unknown renderer '"+rendererType+"'");
+
+    OSPModel model = ospNewModel();
+    double t0 = getSysTime();
+    box3f bounds;
+    if      (scene == "spheres")      bounds = makeSpheres(model,renderer,rendererType,config);
+    else if (scene == "streamlines")  bounds = makeStreamLines(model,renderer,rendererType,config);
+    else if (scene == "trianglemesh") bounds = makeTriangleMesh(model,renderer,rendererType,config);
+    else if (scene == "volume")       bounds = makeVolume(model,renderer,rendererType,config);
+    else if (scene == "materials")    bounds = makeMaterials(model,renderer,rendererType,config);
+    else throw std::runtime_error("unknown scene '"+scene+"'");
+    double t1 = getSysTime();
+    ospCommit(model);
+    double t2 = getSysTime();
+    run.sceneSetupTime = t1 - t0;
+    run.modelCommitTime = t2 - t1;
+    run.rssAfterCommit = residentSetSize();
+
+    // look at the center of the scene from a fixed direction
+    const vec3f center = .5f*(bounds.lower+bounds.upper);
+    const vec3f dir = normalize(vec3f(-.5f,-.6f,-1.f));
+    const vec3f pos = center - 1.2f*length(bounds.upper-bounds.lower) * dir;
+    OSPCamera camera = ospNewCamera("perspective");
+    ospSetf(camera,"aspect",config.width/float(config.height));
+    ospSet3f(camera,"pos",pos.x,pos.y,pos.z);
+    ospSet3f(camera,"dir",dir.x,dir.y,dir.z);
+    ospSet3f(camera,"up",0.f,1.f,0.f);
+    ospCommit(camera);
+
+    OSPLight light = ospNewLight(renderer,"DirectionalLight");
+    if (light) {
+      ospSet3f(light,"direction",-.3f,-1.f,-.2f);
+      ospCommit(light);
+      // the data array takes over the reference to the light
+      OSPData lights = ospNewData(1,OSP_OBJECT,&light);
+      ospCommit(lights);
+      ospSetData(renderer,"lights",lights);
+      ospRelease(lights);
+    }
+
+    ospSetObject(renderer,"model",model);
+    ospSetObject(renderer,"camera",camera);
+    ospSet1i(renderer,"spp",config.spp);
+    if (rendererType == "raycast_volume_renderer") {
+      OSPModel dynamicModel = ospNewModel();
+      ospCommit(dynamicModel);
+      ospSetObject(renderer,"dynamic_model",dynamicModel);
+      ospRelease(dynamicModel);
+    }
+    ospCommit(renderer);
+
+    OSPFrameBuffer fb = ospNewFrameBuffer(osp::vec2i(config.width,config.height),
+                                          OSP_RGBA_I8,OSP_FB_COLOR|OSP_FB_ACCUM);
+
+    // every frame starts from a cleared accumulation buffer, so all
+    // frames do the same work
+    for (int f=0;f<config.warmupFrames+config.timedFrames;f++) {
+      ospFrameBufferClear(fb,OSP_FB_COLOR|OSP_FB_ACCUM);
+      const double frameStart = getSysTime();
+      ospRenderFrame(fb,renderer,OSP_FB_COLOR|OSP_FB_ACCUM);
+      const double frameTime = getSysTime() - frameStart;
+      if (f >= config.warmupFrames)
+        run.frameTimes.push_back(frameTime);
+    }
+    run.rssAfterRender = residentSetSize();
+    // without a resettable peak, the process-wide peak would repeat
+    // the largest earlier run, so fall back to the sampled maximum
+    run.rssPeak = peakReset
+      ? peakResidentSetSize()
+      : std::max(run.rssBefore,std::max(run.rssAfterCommit,run.rssAfterRender));
+
+    if (config.writeImages) {
+      const uint32 *pixel = (const uint32 *)ospMapFrameBuffer(fb,OSP_FB_COLOR);
+      writePPM(scene+"_"+rendererType+".ppm",config.width,config.height,pixel);
+      ospUnmapFrameBuffer(pixel,fb);
+    }
+
+    ospFreeFrameBuffer(fb);
+    ospRelease(renderer);
+    ospRelease(camera);
+    ospRelease(model);
+    return run;
+  }
+
+  void writeJSON(FILE *out, const Config &config, const std::vector<Run> &runs)
+  {
+    fprintf(out,"{\n");
+    fprintf(out,"  \"config\": {\n");
+    fprintf(out,"    \"width\": %i, \"height\": %i, \"spp\": %i, \"threads\": %i,\n",
+            config.width,config.height,config.spp,config.numThreads);
+    fprintf(out,"    \"warmupFrames\": %i, \"timedFrames\": %i, \"scale\": %g\n",
+            config.warmupFrames,config.timedFrames,config.scale);
+    fprintf(out,"  },\n");
+    fprintf(out,"  \"runs\": [\n");
+    for (size_t i=0;i<runs.size();i++) {
+      const Run &run = runs[i];
+      std::vector<double> sorted = run.frameTimes;
+      std::sort(sorted.begin(),sorted.end());
+      double sum = 0.;
+      for (size_t f=0;f<sorted.size();f++) sum += sorted[f];
+
+      fprintf(out,"    {\n");
+      fprintf(out,"      \"scene\": \"%s\", \"renderer\": \"%s\",\n",run.scene.c_str(),run.renderer.c_str());
+      fprintf(out,"      \"sceneSetupSeconds\": %.6f,\n",run.sceneSetupTime);
+      fprintf(out,"      \"bvhBuildSeconds\": %.6f,\n",run.modelCommitTime);
+      fprintf(out,"      \"memory\": { \"rssBeforeBytes\": %lli, \"rssAfterBuildBytes\": %lli, "
+              "\"rssAfterRenderBytes\": %lli, \"peakRssBytes\": %lli },\n",
+              (long long)run.rssBefore,(long long)run.rssAfterCommit,
+              (long long)run.rssAfterRender,(long long)run.rssPeak);
+      if (!sorted.empty())
+        fprintf(out,"      \"frameSeconds\": { \"min\": %.6f, \"median\": %.6f, \"mean\": %.6f, \"max\": %.6f },\n",
+                sorted.front(),sorted[sorted.size()/2],sum/sorted.size(),sorted.back());
+      fprintf(out,"      \"frameTimes\": [");
+      for (size_t f=0;f<run.frameTimes.size();f++)
+        fprintf(out,"%s%.6f",f ? ", " : "",run.frameTimes[f]);
+      fprintf(out,"]\n");
+      fprintf(out,"    }%s\n",i+1 < runs.size() ? "," : "");
+    }
+    fprintf(out,"  ]\n");
+    fprintf(out,"}\n");
+  }
+
+  void usage(const char *error = NULL)
+  {
+    if (error)
+      cout << "ospBenchmark: " << error << endl << endl;
+    cout << "usage: ospBenchmark [options]" << endl
+         << "  --scene <name>      scene to render, may be repeated (default: all of" << endl
+         << "                      spheres, streamlines, trianglemesh, volume, materials)" << endl
+         << "  --renderer <name>   renderer to use, may be repeated (default: all of raycast," << endl
+         << "                      ao, obj, pathtracer, raycast_volume_renderer)" << endl
+         << "  --size <w> <h>      frame buffer resolution (default: 1024 768)" << endl
+         << "  --spp <n>           samples per pixel (default: 1)" << endl
+         << "  --threads <n>       number of render threads (default: all)" << endl
+         << "  --warmup <n>        untimed frames before measuring (default: 2)" << endl
+         << "  --frames <n>        timed frames (default: 10)" << endl
+         << "  --scale <f>         scales primitive and voxel counts (default: 1)" << endl
+         << "  -o <file>           JSON output file, '-' for stdout (default: ospBenchmark.json)" << endl
+         << "  --write-images      write the last frame of each run as <scene>_<renderer>.ppm" << endl;
+    exit(error ? 1 : 0);
+  }
+
+  int benchmarkMain(int ac, const char **av)
+  {
+    Config config;
+    for (int i=1;i<ac;i++) {
+      const std::string arg = av[i];
+      const bool hasValue = i+1 < ac;
+      if (arg == "--scene" && hasValue)
+        config.scenes.push_back(av[++i]);
+      else if (arg == "--renderer" && hasValue)
+        config.renderers.push_back(av[++i]);
+      else if (arg == "--size" && i+2 < ac) {
+        config.width  = atoi(av[++i]);
+        config.height = atoi(av[++i]);
+      } else if (arg == "--spp" && hasValue)
+        config.spp = atoi(av[++i]);
+      else if (arg == "--threads" && hasValue)
+        config.numThreads = atoi(av[++i]);
+      else if (arg == "--warmup" && hasValue)
+        config.warmupFrames = atoi(av[++i]);
+      else if (arg == "--frames" && hasValue)
+        config.timedFrames = atoi(av[++i]);
+      else if (arg == "--scale" && hasValue)
+        config.scale = atof(av[++i]);
+      else if (arg == "-o" && hasValue)
+        config.outputFileName = av[++i];
+      else if (arg == "--write-images")
+        config.writeImages = true;
+      else if (arg == "--help" || arg == "-h")
+        usage();
+      else
+        usage(("unknown or incomplete argument '"+arg+"'").c_str());
+    }
+    if (config.width <= 0 || config.height <= 0 || config.timedFrames <= 0 || config.scale <= 0.f)
+      usage("invalid frame size, frame count, or scale");
+
+    // the thread count is an ospray parameter
+    std::vector<const char *> ospArgs(1,av[0]);
+    char numThreads[32];
+    if (config.numThreads > 0) {
+      sprintf(numThreads,"%i",config.numThreads);
+      ospArgs.push_back("--osp:numthreads");
+      ospArgs.push_back(numThreads);
+    }
+    int ospArgCount = ospArgs.size();
+    ospInit(&ospArgCount,&ospArgs[0]);
+
+    const bool allCombinations = config.scenes.empty() && config.renderers.empty();
+    if (config.scenes.empty())
+      config.scenes.assign(allScenes,allScenes+sizeof(allScenes)/sizeof(allScenes[0]));
+    if (config.renderers.empty())
+      config.renderers.assign(allRenderers,allRenderers+sizeof(allRenderers)/sizeof(allRenderers[0]));
+
+    std::vector<Run> runs;
+    for (size_t s=0;s<config.scenes.size();s++)
+      for (size_t r=0;r<config.renderers.size();r++) {
+        const std::string &scene = config.scenes[s], &renderer = config.renderers[r];
+        if (!compatible(scene,renderer)) {
+          if (!allCombinations)
+            std::cerr << "ospBenchmark: skipping scene '" << scene
+                      << "' with renderer '" << renderer << "'" << endl;
+          continue;
+        }
+        std::cerr << "ospBenchmark: scene '" << scene << "', renderer '" << renderer << "'" << endl;
+        runs.push_back(runBenchmark(scene,renderer,config));
+      }
+
+    FILE *out = config.outputFileName == "-" ? stdout : fopen(config.outputFileName.c_str(),"w");
+    if (!out)
+      throw std::runtime_error("could not open '"+config.outputFileName+"' for writing");
+    writeJSON(out,config,runs);
+    if (out != stdout) fclose(out);
+    return 0;
+  }
+
+} // ::ospray
+
+int main(int ac, const char **av)
+{
+  try {
+    return ospray::benchmarkMain(ac,av);
+  } catch (const std::runtime_error &e) {
+    std::cerr << "ospBenchmark: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -16,19 +16,542 @@
 
 #include "miniSG.h"
 #include "importer.h"
+// stdlib, for mmap
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*! \file importMSG.cpp Binary MiniSG ('.msg') file format
+
+  A MSG file is a flat dump of a miniSG::Model: a header, followed by
+  the model's textures, materials, meshes, instances, and cameras. All
+  bulk arrays (positions, normals, triangles, texels, ...) are stored
+  as raw, 16-byte aligned blocks, so loading a model is a single mmap
+  plus one copy per array, without any parsing.
+
+  The same format is used for the model cache (see importCached()),
+  in which case the header also records size and modification time of
+  the file the model was originally imported from, and the header is
+  followed by the same information for all other files the importer
+  read (material libraries, textures, binary companion files).
+*/
 
 namespace ospray {
   namespace miniSG {
     using std::cout;
     using std::endl;
 
+    /*! magic number at the start of every MSG file ("MSG\0") */
+    static const uint32 msgMagic   = 0x0047534d;
+    /*! bump this whenever the layout below changes */
+    static const uint32 msgVersion = 3;
+
+    struct MSGHeader {
+      uint32 magic;
+      uint32 version;
+      /*! size and mtime of the source file, if this is a cache file; 0 otherwise */
+      uint64 sourceSize;
+      int64  sourceTime;
+    };
+
+    /*! a file other than the source file that a cached model was
+        imported from */
+    struct MSGDependency {
+      std::string fileName;
+      uint64      size;
+      int64       time;
+    };
+
+    /*! files recorded through addImportDependency() while importCached()
+        runs an importer; NULL otherwise */
+    static std::vector<MSGDependency> *currentDependencies = NULL;
+
+    void addImportDependency(const embree::FileName &fileName)
+    {
+      if (!currentDependencies) return;
+      for (size_t i=0;i<currentDependencies->size();i++)
+        if ((*currentDependencies)[i].fileName == fileName.str()) return;
+      MSGDependency dep;
+      dep.fileName = fileName.str();
+      struct stat st;
+      if (stat(fileName.c_str(),&st) == 0) {
+        dep.size = st.st_size;
+        dep.time = st.st_mtime;
+      } else {
+        // a file that does not exist (yet) is recorded as such
+        dep.size = uint64(-1);
+        dep.time = 0;
+      }
+      currentDependencies->push_back(dep);
+    }
+
+    // ------------------------------------------------------------------
+    // writing
+    // ------------------------------------------------------------------
+
+    struct MSGWriter {
+      FILE *file;
+      size_t ofs;
+
+      MSGWriter(FILE *file) : file(file), ofs(0) {}
+
+      void write(const void *ptr, size_t numBytes)
+      {
+        if (numBytes && fwrite(ptr,numBytes,1,file) != 1)
+          throw std::runtime_error("#osp:minisg: error writing MSG file");
+        ofs += numBytes;
+      }
+      template<typename T>
+      void write(const T &t) { write(&t,sizeof(t)); }
+
+      void write(const std::string &s)
+      {
+        write(uint64(s.size()));
+        write(s.data(),s.size());
+      }
+
+      /*! write array of 'num' items, with the items 16-byte aligned in the file */
+      template<typename T>
+      void writeArray(const std::vector<T> &v)
+      {
+        write(uint64(v.size()));
+        align();
+        if (!v.empty()) write(&v[0],v.size()*sizeof(T));
+      }
+
+      void align()
+      {
+        static const char zero[16] = { 0 };
+        write(zero,(16 - ofs%16)%16);
+      }
+    };
+
+    static int64 findID(std::map<const void *,int64> &ids, const void *ptr)
+    {
+      if (!ptr) return -1;
+      std::map<const void *,int64>::iterator it = ids.find(ptr);
+      return it == ids.end() ? -1 : it->second;
+    }
+
+    static void writeMSG(Model &model, const embree::FileName &fileName,
+                         const MSGHeader &header,
+                         const std::vector<MSGDependency> &dependencies)
+    {
+      FILE *file = fopen(fileName.c_str(),"wb");
+      if (!file)
+        throw std::runtime_error("#osp:minisg: could not open '"+fileName.str()+"' for writing");
+
+      try {
+        MSGWriter out(file);
+        out.write(header);
+        out.write(uint64(dependencies.size()));
+        for (size_t i=0;i<dependencies.size();i++) {
+          out.write(dependencies[i].fileName);
+          out.write(dependencies[i].size);
+          out.write(dependencies[i].time);
+        }
+
+        // collect all materials and textures the model refers to
+        std::vector<Material *>  material;
+        std::vector<Texture2D *> texture;
+        std::map<const void *,int64> materialID, textureID;
+        for (size_t i=0;i<model.mesh.size();i++) {
+          std::vector<Material *> meshMaterials;
+          if (model.mesh[i]->material) meshMaterials.push_back(model.mesh[i]->material.ptr);
+          for (size_t j=0;j<model.mesh[i]->materialList.size();j++)
+            if (model.mesh[i]->materialList[j])
+              meshMaterials.push_back(model.mesh[i]->materialList[j].ptr);
+
+          for (size_t j=0;j<meshMaterials.size();j++) {
+            Material *mat = meshMaterials[j];
+            if (materialID.find(mat) != materialID.end()) continue;
+            materialID[mat] = material.size();
+            material.push_back(mat);
+
+            std::vector<Texture2D *> matTextures;
+            for (size_t k=0;k<mat->textures.size();k++)
+              matTextures.push_back(mat->textures[k].ptr);
+            for (Material::ParamMap::const_iterator it = mat->params.begin();
+                 it != mat->params.end(); it++)
+              if (it->second->type == Material::Param::TEXTURE)
+                matTextures.push_back((Texture2D *)it->second->ptr);
+            for (size_t k=0;k<matTextures.size();k++) {
+              Texture2D *tex = matTextures[k];
+              if (!tex || textureID.find(tex) != textureID.end()) continue;
+              textureID[tex] = texture.size();
+              texture.push_back(tex);
+            }
+          }
+        }
+
+        // textures
+        out.write(uint64(texture.size()));
+        for (size_t i=0;i<texture.size();i++) {
+          const Texture2D *tex = texture[i];
+          out.write(int32(tex->channels));
+          out.write(int32(tex->depth));
+          out.write(int32(tex->width));
+          out.write(int32(tex->height));
+          out.write(int32(tex->blockFormat));
+          out.align();
+          out.write(tex->data,tex->numBytes());
+        }
+
+        // materials
+        out.write(uint64(material.size()));
+        for (size_t i=0;i<material.size();i++) {
+          const Material *mat = material[i];
+          out.write(mat->name);
+          out.write(mat->type);
+          out.write(uint64(mat->textures.size()));
+          for (size_t k=0;k<mat->textures.size();k++)
+            out.write(findID(textureID,mat->textures[k].ptr));
+          out.write(uint64(mat->params.size()));
+          for (Material::ParamMap::const_iterator it = mat->params.begin();
+               it != mat->params.end(); it++) {
+            const Material::Param *p = it->second.ptr;
+            out.write(it->first);
+            out.write(int32(p->type));
+            switch (p->type) {
+            case Material::Param::STRING:
+              out.write(std::string(p->s ? p->s : ""));
+              break;
+            case Material::Param::TEXTURE:
+              out.write(findID(textureID,p->ptr));
+              break;
+            default:
+              out.write(p->f,sizeof(p->f));
+              break;
+            }
+          }
+        }
+
+        // meshes
+        out.write(uint64(model.mesh.size()));
+        for (size_t i=0;i<model.mesh.size();i++) {
+          const Mesh *mesh = model.mesh[i].ptr;
+          out.write(mesh->name);
+          out.write(findID(materialID,mesh->material.ptr));
+          out.write(uint64(mesh->materialList.size()));
+          for (size_t j=0;j<mesh->materialList.size();j++)
+            out.write(findID(materialID,mesh->materialList[j].ptr));
+          out.writeArray(mesh->position);
+          out.writeArray(mesh->normal);
+          out.writeArray(mesh->color);
+          out.writeArray(mesh->texcoord);
+          out.writeArray(mesh->triangle);
+          out.writeArray(mesh->triangleMaterialId);
+        }
+
+        // instances
+        out.write(uint64(model.instance.size()));
+        for (size_t i=0;i<model.instance.size();i++) {
+          out.write(int32(model.instance[i].meshID));
+          out.write(model.instance[i].xfm);
+        }
+
+        // cameras
+        out.write(uint64(model.camera.size()));
+        for (size_t i=0;i<model.camera.size();i++) {
+          out.write(model.camera[i]->from);
+          out.write(model.camera[i]->at);
+          out.write(model.camera[i]->up);
+        }
+      } catch (std::runtime_error e) {
+        fclose(file);
+        unlink(fileName.c_str());
+        throw;
+      }
+      fclose(file);
+    }
+
+    // ------------------------------------------------------------------
+    // reading
+    // ------------------------------------------------------------------
+
+    struct MSGReader {
+      const unsigned char *base, *end;
+      size_t ofs;
+
+      MSGReader(const void *base, size_t size)
+        : base((const unsigned char *)base), end((const unsigned char *)base+size), ofs(0)
+      {}
+
+      const void *read(size_t numBytes)
+      {
+        if (ofs + numBytes > size_t(end-base))
+          throw std::runtime_error("#osp:minisg: truncated MSG file");
+        const void *ptr = base+ofs;
+        ofs += numBytes;
+        return ptr;
+      }
+      template<typename T>
+      T read() { return *(const T *)read(sizeof(T)); }
+
+      std::string readString()
+      {
+        const uint64 size = read<uint64>();
+        return std::string((const char *)read(size),size);
+      }
+
+      template<typename T>
+      void readArray(std::vector<T> &v)
+      {
+        const uint64 num = read<uint64>();
+        align();
+        const T *begin = (const T *)read(num*sizeof(T));
+        v.assign(begin,begin+num);
+      }
+
+      void align() { read((16 - ofs%16)%16); }
+    };
+
+    template<typename T>
+    static T *lookup(std::vector<Ref<T> > &v, int64 ID)
+    {
+      if (ID < 0) return NULL;
+      if (ID >= (int64)v.size())
+        throw std::runtime_error("#osp:minisg: invalid object ID in MSG file");
+      return v[ID].ptr;
+    }
+
+    /*! parse MSG file content (after the header) into an empty 'model' */
+    static void parseMSG(Model &model, MSGReader &in)
+    {
+      // textures
+      std::vector<Ref<Texture2D> > texture(in.read<uint64>());
+      for (size_t i=0;i<texture.size();i++) {
+        Texture2D *tex = new Texture2D;
+        tex->channels = in.read<int32>();
+        tex->depth    = in.read<int32>();
+        tex->width    = in.read<int32>();
+        tex->height   = in.read<int32>();
+        tex->blockFormat = (OSPDataType)in.read<int32>();
+        in.align();
+        const size_t numBytes = tex->numBytes();
+        tex->data = new unsigned char[numBytes];
+        memcpy(tex->data,in.read(numBytes),numBytes);
+        texture[i] = tex;
+      }
+
+      // materials
+      std::vector<Ref<Material> > material(in.read<uint64>());
+      for (size_t i=0;i<material.size();i++) {
+        Material *mat = new Material;
+        mat->name = in.readString();
+        mat->type = in.readString();
+        const uint64 numTextures = in.read<uint64>();
+        for (size_t k=0;k<numTextures;k++)
+          mat->textures.push_back(lookup(texture,in.read<int64>()));
+        const uint64 numParams = in.read<uint64>();
+        for (size_t k=0;k<numParams;k++) {
+          const std::string name = in.readString();
+          const Material::Param::DataType type = (Material::Param::DataType)in.read<int32>();
+          switch (type) {
+          case Material::Param::STRING:
+            mat->setParam(name.c_str(),in.readString().c_str());
+            break;
+          case Material::Param::TEXTURE: {
+            Texture2D *tex = lookup(texture,in.read<int64>());
+            // the param only stores a raw pointer, so the material has
+            // to hold a reference to keep the texture alive
+            bool referenced = (tex == NULL);
+            for (size_t t=0;t<mat->textures.size() && !referenced;t++)
+              referenced = (mat->textures[t].ptr == tex);
+            if (!referenced)
+              mat->textures.push_back(tex);
+            mat->setParam(name.c_str(),(void *)tex,type);
+          } break;
+          default: {
+            Material::Param *p = new Material::Param;
+            p->type = type;
+            memcpy(p->f,in.read(sizeof(p->f)),sizeof(p->f));
+            mat->params[name] = p;
+          } break;
+          }
+        }
+        material[i] = mat;
+      }
+
+      // meshes
+      const uint64 numMeshes = in.read<uint64>();
+      for (size_t i=0;i<numMeshes;i++) {
+        Mesh *mesh = new Mesh;
+        mesh->name = in.readString();
+        mesh->material = lookup(material,in.read<int64>());
+        mesh->materialList.resize(in.read<uint64>());
+        for (size_t j=0;j<mesh->materialList.size();j++)
+          mesh->materialList[j] = lookup(material,in.read<int64>());
+        in.readArray(mesh->position);
+        in.readArray(mesh->normal);
+        in.readArray(mesh->color);
+        in.readArray(mesh->texcoord);
+        in.readArray(mesh->triangle);
+        in.readArray(mesh->triangleMaterialId);
+        model.mesh.push_back(mesh);
+      }
+
+      // instances
+      const uint64 numInstances = in.read<uint64>();
+      for (size_t i=0;i<numInstances;i++) {
+        const int32    meshID = in.read<int32>();
+        const affine3f xfm    = in.read<affine3f>();
+        model.instance.push_back(Instance(meshID,xfm));
+      }
+
+      // cameras
+      const uint64 numCameras = in.read<uint64>();
+      for (size_t i=0;i<numCameras;i++) {
+        Camera *camera = new Camera;
+        camera->from = in.read<vec3f>();
+        camera->at   = in.read<vec3f>();
+        camera->up   = in.read<vec3f>();
+        model.camera.push_back(camera);
+      }
+    }
+
+    /*! read the dependency list following the header; returns true if
+        all dependencies still have the recorded size and mtime */
+    static bool dependenciesUnchanged(MSGReader &in)
+    {
+      bool unchanged = true;
+      const uint64 numDependencies = in.read<uint64>();
+      for (size_t i=0;i<numDependencies;i++) {
+        const std::string fileName = in.readString();
+        const uint64 size = in.read<uint64>();
+        const int64  time = in.read<int64>();
+        struct stat st;
+        if (stat(fileName.c_str(),&st) != 0)
+          unchanged &= (size == uint64(-1));
+        else
+          unchanged &= (size == uint64(st.st_size) && time == int64(st.st_mtime));
+      }
+      return unchanged;
+    }
+
+    /*! move all content of 'imported' into 'model' */
+    static void appendModel(Model &model, const Model &imported)
+    {
+      const size_t meshBase = model.mesh.size();
+      model.mesh.insert(model.mesh.end(),imported.mesh.begin(),imported.mesh.end());
+      for (size_t i=0;i<imported.instance.size();i++) {
+        model.instance.push_back(imported.instance[i]);
+        model.instance.back().meshID += meshBase;
+      }
+      model.camera.insert(model.camera.end(),imported.camera.begin(),imported.camera.end());
+    }
+
+    /*! map given MSG file, check its header, and import it. returns
+        false (and leaves 'model' untouched) if the file does not exist,
+        or its header does not match 'expected', or (if 'expected' is
+        given) any of the files recorded as dependencies changed */
+    static bool readMSG(Model &model, const embree::FileName &fileName,
+                        const MSGHeader *expected)
+    {
+      int fd = ::open(fileName.c_str(),O_RDONLY);
+      if (fd == -1) return false;
+
+      struct stat st;
+      fstat(fd,&st);
+      const size_t fileSize = st.st_size;
+      if (fileSize < sizeof(MSGHeader)) {
+        ::close(fd);
+        return false;
+      }
+      void *mem = mmap(NULL,fileSize,PROT_READ,MAP_SHARED,fd,0);
+      ::close(fd);
+      if (mem == MAP_FAILED) return false;
+
+      bool valid = false;
+      MSGReader in(mem,fileSize);
+      const MSGHeader header = in.read<MSGHeader>();
+      if (header.magic == msgMagic && header.version == msgVersion &&
+          (!expected || (header.sourceSize == expected->sourceSize &&
+                         header.sourceTime == expected->sourceTime))) {
+        // parse into a temporary model so a broken file doesn't leave
+        // a half-imported model behind
+        Model imported;
+        try {
+          if (dependenciesUnchanged(in) || !expected) {
+            parseMSG(imported,in);
+            valid = true;
+          }
+        } catch (std::runtime_error e) {
+          cout << e.what() << endl;
+        }
+        if (valid) appendModel(model,imported);
+      }
+      munmap(mem,fileSize);
+      return valid;
+    }
+
+    // ------------------------------------------------------------------
+    // public interface
+    // ------------------------------------------------------------------
+
     void importMSG(Model &model,
                    const embree::FileName &fileName)
     {
-      error("importMSG: not implemented yet");
+      if (!readMSG(model,fileName,NULL))
+        error("importMSG: could not read MSG file '"+fileName.str()+"'");
     }
 
-  } // ::ospray::minisg
-} // ::ospray
+    void exportMSG(Model &model,
+                   const embree::FileName &fileName)
+    {
+      MSGHeader header;
+      header.magic      = msgMagic;
+      header.version    = msgVersion;
+      header.sourceSize = 0;
+      header.sourceTime = 0;
+      writeMSG(model,fileName,header,std::vector<MSGDependency>());
+    }
+
+    void importCached(Model &model,
+                      const embree::FileName &fileName,
+                      Importer importer)
+    {
+      const embree::FileName cacheName = fileName.str()+".msg";
+
+      struct stat st;
+      if (stat(fileName.c_str(),&st) != 0) {
+        // no source file to validate a cache against; just import
+        importer(model,fileName);
+        return;
+      }
+      MSGHeader header;
+      header.magic      = msgMagic;
+      header.version    = msgVersion;
+      header.sourceSize = st.st_size;
+      header.sourceTime = st.st_mtime;
+
+      if (readMSG(model,cacheName,&header)) {
+        cout << "#osp:minisg: loaded '" << fileName.str()
+             << "' from cache '" << cacheName.str() << "'" << endl;
+        return;
+      }
 
+      Model imported;
+      std::vector<MSGDependency> dependencies;
+      currentDependencies = &dependencies;
+      try {
+        importer(imported,fileName);
+      } catch (...) {
+        currentDependencies = NULL;
+        throw;
+      }
+      currentDependencies = NULL;
+      try {
+        writeMSG(imported,cacheName,header,dependencies);
+        cout << "#osp:minisg: wrote model cache '" << cacheName.str() << "'" << endl;
+      } catch (std::runtime_error e) {
+        cout << e.what() << " - not caching '" << fileName.str() << "'" << endl;
+      }
 
+      appendModel(model,imported);
+    }
+
+  } // ::ospray::minisg
+} // ::ospray
@@ -16,6 +16,16 @@
 
 #include "miniSG.h"
 #include "importer.h"
+// embree
+#include "common/sys/thread.h"
+#include "common/sys/sysinfo.h"
+#include "common/sys/sync/atomic.h"
+// stdlib, for mmap
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <fstream>
 
 /*! the boeing 777 model does not actually have a 'mtl' file; instead,
@@ -40,13 +50,6 @@ namespace ospray {
       Vertex(int v, int vt, int vn) : v(v), vt(vt), vn(vn) {};
     };
     
-    static inline bool operator < ( const Vertex& a, const Vertex& b ) {
-      if (a.v  != b.v)  return a.v  < b.v;
-      if (a.vn != b.vn) return a.vn < b.vn;
-      if (a.vt != b.vt) return a.vt < b.vt;
-      return false;
-    }
-    
     /*! Fill space at the end of the token with 0s. */
     static inline const char* trimEnd(const char* token) {
       size_t len = strlen(token);
@@ -96,137 +99,687 @@ namespace ospray {
       return vec3f(x,y,z);
     }
     
+    // ------------------------------------------------------------------
+    // bounded parsing helpers for the mmapped file (which is not
+    // zero-terminated, so none of these may run past 'end')
+    // ------------------------------------------------------------------
+
+    /*! skip blanks, but never past 'end' */
+    static inline void skipSep(const char*& s, const char* end) {
+      while (s < end && isSep(*s)) ++s;
+    }
+
+    /*! returns true if 's' is at the end of the current token */
+    static inline bool atTokenEnd(const char* s, const char* end) {
+      return s >= end || isSep(*s) || *s == '\r' || *s == '/';
+    }
+
+    /*! Read (signed) int, like atoi(). */
+    static inline int parseInt(const char*& s, const char* end) {
+      bool neg = false;
+      if (s < end && (*s == '-' || *s == '+')) neg = (*s++ == '-');
+      int n = 0;
+      while (s < end && *s >= '0' && *s <= '9') n = 10*n + (*s++ - '0');
+      return neg ? -n : n;
+    }
+
+    /*! Read float; handles the common '[-]ddd.ddd[e[-]dd]' case
+        directly and falls back to strtod() for everything else
+        (nan, inf, ...). */
+    static inline float parseFloat(const char*& s, const char* end) {
+      static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+
+      skipSep(s,end);
+      const char* begin = s;
+      bool neg = false;
+      if (s < end && (*s == '-' || *s == '+')) neg = (*s++ == '-');
+
+      uint64 mantissa  = 0;
+      int    exponent  = 0;
+      int    numDigits = 0; // significant digits in mantissa
+      bool   anyDigits = false;
+      for (; s < end && *s >= '0' && *s <= '9'; ++s) {
+        anyDigits = true;
+        if (numDigits < 18) {
+          mantissa = 10*mantissa + (*s - '0');
+          if (mantissa) ++numDigits;
+        } else
+          ++exponent;
+      }
+      if (s < end && *s == '.') {
+        for (++s; s < end && *s >= '0' && *s <= '9'; ++s) {
+          anyDigits = true;
+          if (numDigits < 18) {
+            mantissa = 10*mantissa + (*s - '0');
+            if (mantissa) ++numDigits;
+            --exponent;
+          }
+        }
+      }
+      if (anyDigits && s < end && (*s == 'e' || *s == 'E')) {
+        ++s;
+        exponent += parseInt(s,end);
+      }
+
+      if (!anyDigits || !atTokenEnd(s,end)) {
+        // something we don't handle ourselves - let the c library deal with it
+        char token[64];
+        size_t len = 0;
+        for (s = begin; s < end && !isSep(*s) && *s != '\r'; ++s)
+          if (len < sizeof(token)-1) token[len++] = *s;
+        token[len] = 0;
+        return (float)strtod(token,NULL);
+      }
+
+      double value = (double)mantissa;
+      if (exponent < 0)
+        value = (-exponent <= 22) ? value / pow10[-exponent] : value * pow(10.,exponent);
+      else if (exponent > 0)
+        value = (exponent <= 22) ? value * pow10[exponent] : value * pow(10.,exponent);
+      return (float)(neg ? -value : value);
+    }
+
+    /*! returns pointer to the '\n' ending the line that starts at 's', or 'end' */
+    static inline const char* findLineEnd(const char* s, const char* end) {
+      const char* nl = (const char*)memchr(s,'\n',end-s);
+      return nl ? nl : end;
+    }
+
+    /*! returns true if the given physical line is continued with a '\' */
+    static inline bool isContinued(const char* begin, const char* lineEnd) {
+      if (lineEnd > begin && lineEnd[-1] == '\r') --lineEnd;
+      return lineEnd > begin && lineEnd[-1] == '\\';
+    }
+
+    /*! Extract the next logical line from [s,end) into [lb,le). Lines
+        continued with '\' get joined (with the '\' replaced by a
+        blank) into 'buffer', all others are returned in-place. */
+    static bool nextLine(const char*& s, const char* end, std::string& buffer,
+                         const char*& lb, const char*& le) {
+      if (s >= end) return false;
+      const char* e = findLineEnd(s,end);
+      lb = s; le = e;
+      s = (e < end) ? e+1 : end;
+      if (le > lb && le[-1] == '\r') --le;
+      if (le == lb || le[-1] != '\\') return true;
+
+      buffer.assign(lb,le-1);
+      buffer += ' ';
+      while (s < end) {
+        const char* b = s;
+        e = findLineEnd(s,end);
+        s = (e < end) ? e+1 : end;
+        const char* ee = e;
+        if (ee > b && ee[-1] == '\r') --ee;
+        if (ee > b && ee[-1] == '\\') {
+          buffer.append(b,ee-1);
+          buffer += ' ';
+          continue;
+        }
+        buffer.append(b,ee);
+        break;
+      }
+      lb = buffer.data();
+      le = lb + buffer.size();
+      return true;
+    }
+
+    /*! line types the importer cares about */
+    typedef enum { OBJ_V, OBJ_VN, OBJ_VT, OBJ_F, OBJ_USEMTL, OBJ_MTLLIB, OBJ_OTHER } OBJLineType;
+
+    /*! classify the (blank-trimmed) line starting at 't'; on return 't'
+        points to the first character after the keyword */
+    static inline OBJLineType classifyLine(const char*& t, const char* le) {
+      const size_t len = le - t;
+      if (len < 2) return OBJ_OTHER;
+      if (t[0] == 'v' && isSep(t[1])) { t += 2; return OBJ_V; }
+      if (t[0] == 'f' && isSep(t[1])) { t += 2; return OBJ_F; }
+      if (len < 3) return OBJ_OTHER;
+      if (t[0] == 'v' && t[1] == 'n' && isSep(t[2])) { t += 3; return OBJ_VN; }
+      if (t[0] == 'v' && t[1] == 't' && isSep(t[2])) { t += 3; return OBJ_VT; }
+      if (len < 7) return OBJ_OTHER;
+      if (!strncmp(t, "usemtl", 6) && isSep(t[6])) { t += 7; return OBJ_USEMTL; }
+      if (!strncmp(t, "mtllib", 6) && isSep(t[6])) { t += 7; return OBJ_MTLLIB; }
+      return OBJ_OTHER;
+    }
+
+    /*! returns the remainder of the line as a string, without surrounding blanks */
+    static inline std::string getName(const char* t, const char* le) {
+      skipSep(t,le);
+      while (le > t && isSep(le[-1])) --le;
+      return std::string(t,le);
+    }
+
+    // ------------------------------------------------------------------
+    // vertex deduplication
+    // ------------------------------------------------------------------
+
+    static inline bool operator == ( const Vertex& a, const Vertex& b ) {
+      return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+    }
+
+    static inline uint32 hashVertex(const Vertex& i) {
+      uint32 h = uint32(i.v) * 0x9E3779B1u;
+      h ^= uint32(i.vt) * 0x85EBCA77u + (h << 6) + (h >> 2);
+      h ^= uint32(i.vn) * 0xC2B2AE3Du + (h << 6) + (h >> 2);
+      return h ^ (h >> 16);
+    }
+
+    /*! Open-addressing (linear probing) hash map from three-index
+        vertices to mesh vertex IDs. It starts out sized for the
+        expected number of distinct vertices and doubles whenever it
+        gets half full. */
+    struct VertexMap {
+      static const uint32 EMPTY = uint32(-1);
+
+      VertexMap(size_t expectedNumVertices) : count(0) {
+        size_t size = 16;
+        while (size < 2*expectedNumVertices) size *= 2;
+        mask = size-1;
+        key.resize(size);
+        value.assign(size,EMPTY);
+      }
+
+      /*! returns the slot holding 'i', or the empty slot it should go in */
+      inline size_t find(const Vertex& i) const {
+        size_t slot = hashVertex(i) & mask;
+        while (value[slot] != EMPTY && !(key[slot] == i))
+          slot = (slot+1) & mask;
+        return slot;
+      }
+
+      /*! stores 'id' for 'i' in the empty 'slot' returned by find();
+          may grow the map, which moves the entries */
+      inline void insert(size_t slot, const Vertex& i, uint32 id) {
+        key[slot] = i;
+        value[slot] = id;
+        if (2*++count > key.size()) grow();
+      }
+
+      void grow() {
+        std::vector<Vertex> oldKey;
+        std::vector<uint32> oldValue;
+        oldKey.swap(key);
+        oldValue.swap(value);
+        mask = 2*oldKey.size()-1;
+        key.resize(mask+1);
+        value.assign(mask+1,EMPTY);
+        for (size_t s=0;s<oldKey.size();s++)
+          if (oldValue[s] != EMPTY) {
+            const size_t slot = find(oldKey[s]);
+            key[slot] = oldKey[s];
+            value[slot] = oldValue[s];
+          }
+      }
+
+      std::vector<Vertex> key;
+      std::vector<uint32> value;
+      size_t              mask;
+      size_t              count;
+    };
+    const uint32 VertexMap::EMPTY;
+
+    // ------------------------------------------------------------------
+    // minimal parallel loop (the importer runs before ospray's own
+    // threads are of any use to us)
+    // ------------------------------------------------------------------
+
+    /*! a loop body that gets executed for each index of a parallelFor() */
+    struct ParallelTask {
+      virtual ~ParallelTask() {}
+      virtual void run(size_t taskIndex) = 0;
+    };
+
+    struct ParallelLoop {
+      ParallelTask         *task;
+      size_t                numTasks;
+      embree::AtomicCounter nextTask;
+    };
+
+    static void parallelLoopThread(void* arg) {
+      ParallelLoop* loop = (ParallelLoop*)arg;
+      while (true) {
+        const size_t taskIndex = loop->nextTask++;
+        if (taskIndex >= loop->numTasks) break;
+        loop->task->run(taskIndex);
+      }
+    }
+
+    /*! execute task.run(i) for all i in [0,numTasks), with the
+        indices dynamically distributed across all logical cores */
+    static void parallelFor(ParallelTask& task, size_t numTasks) {
+      ParallelLoop loop;
+      loop.task     = &task;
+      loop.numTasks = numTasks;
+      const size_t numThreads = std::min(numTasks,embree::getNumberOfLogicalThreads());
+      std::vector<embree::thread_t> thread;
+      for (size_t i=1;i<numThreads;i++)
+        thread.push_back(embree::createThread(parallelLoopThread,&loop));
+      parallelLoopThread(&loop);
+      for (size_t i=0;i<thread.size();i++)
+        embree::join(thread[i]);
+    }
+
+    // ------------------------------------------------------------------
+    // the actual loader
+    // ------------------------------------------------------------------
+
+    /*! A range of complete lines of the input file that gets parsed by
+        a single task. Vertex attributes go straight into the loader's
+        global arrays (at this chunk's 'base' offsets, which are known
+        after the counting pass); faces are stored per chunk. */
+    struct OBJChunk {
+      const char* begin;
+      const char* end;
+
+      size_t numV, numVN, numVT;    //!< attribute counts (first pass)
+      size_t baseV, baseVN, baseVT; //!< global index of first attribute
+
+      std::vector<std::string> mtllib; //!< material libraries, in file order
+
+      std::vector<Vertex> corner;     //!< face corners, with global indices
+      std::vector<uint32> faceOffset; //!< face 'i' uses corners [faceOffset[i],faceOffset[i+1])
+      std::vector<std::pair<size_t,std::string> > usemtl; //!< (faceID,name) material switches
+
+      inline size_t numFaces() const { return faceOffset.size()-1; }
+
+      OBJChunk(const char* begin, const char* end)
+        : begin(begin), end(end),
+          numV(0), numVN(0), numVT(0),
+          baseV(0), baseVN(0), baseVT(0),
+          faceOffset(1,0)
+      {}
+    };
+
+    /*! a contiguous range of faces in one chunk */
+    struct OBJFaceRange {
+      const OBJChunk* chunk;
+      size_t          begin, end;
+    };
+
+    /*! all faces between two 'usemtl's; becomes one miniSG::Mesh */
+    struct OBJFaceGroup {
+      Material*                 material;
+      std::vector<OBJFaceRange> range;
+      Mesh*                     mesh;
+    };
+
     class OBJLoader
     {
     public:
-      
-      Model &model;//ImportHelper importer;
-      // std::vector<Handle<Device::RTPrimitive> > model;
+
+      Model &model;
       std::map<std::string,Material *> material;
-      
+
       /*! Constructor. */
       OBJLoader(Model &model, const embree::FileName& fileName);
-      
+
       /*! Destruction */
       ~OBJLoader();
- 
+
       /*! Public methods. */
       void loadMTL(const embree::FileName& fileName);
 
+      /*! first pass: count attributes and find material libraries in chunk 'chunkID' */
+      void countChunk(size_t chunkID);
+      /*! second pass: parse attributes and faces of chunk 'chunkID' */
+      void parseChunk(size_t chunkID);
+      /*! build the mesh for face group 'groupID' */
+      void buildMesh(size_t groupID);
+
     private:
 
       embree::FileName path;
 
-      /*! Geometry buffer. */
+      /*! Geometry buffer, shared by all chunks. */
       std::vector<vec3f> v;
       std::vector<vec3f> vn;
       std::vector<vec2f> vt;
-      std::vector<std::vector<Vertex> > curGroup;
+
+      std::vector<OBJChunk*>    chunk;
+      std::vector<OBJFaceGroup> group;
 
       /*! Material handling. */
-      Material *curMaterial;
       Material *defaultMaterial;
-      //std::map<std::string, Handle<Device::RTMaterial> > material;
 
       /*! Internal methods. */
-      int fix_v (int index);
-      int fix_vt(int index);
-      int fix_vn(int index);
-      void flushFaceGroup();
-      Vertex getInt3(const char*& token);
-      uint32 getVertex(std::map<Vertex,uint32>& vertexMap, Mesh *mesh, const Vertex& i);
+      void splitIntoChunks(const char* begin, const char* end);
+      void collectFaceGroups();
+      Vertex getInt3(const char*& token, const char* end, const OBJChunk& c,
+                     size_t numV, size_t numVT, size_t numVN);
     };
 
-    OBJLoader::OBJLoader(Model &model, const embree::FileName &fileName) 
+    struct OBJCountTask : public ParallelTask {
+      OBJLoader& loader;
+      OBJCountTask(OBJLoader& loader) : loader(loader) {}
+      virtual void run(size_t chunkID) { loader.countChunk(chunkID); }
+    };
+
+    struct OBJParseTask : public ParallelTask {
+      OBJLoader& loader;
+      OBJParseTask(OBJLoader& loader) : loader(loader) {}
+      virtual void run(size_t chunkID) { loader.parseChunk(chunkID); }
+    };
+
+    struct OBJMeshTask : public ParallelTask {
+      OBJLoader& loader;
+      OBJMeshTask(OBJLoader& loader) : loader(loader) {}
+      virtual void run(size_t groupID) { loader.buildMesh(groupID); }
+    };
+
+    OBJLoader::OBJLoader(Model &model, const embree::FileName &fileName)
       : model(model),
-        curMaterial(NULL),
         path(fileName.path())
     {
-      /* open file */
-      std::ifstream cin;
-      cin.open(fileName.c_str());
-      if (!cin.is_open()) {
+      /* map file */
+      int fd = ::open(fileName.c_str(),O_RDONLY);
+      if (fd == -1) {
         std::cerr << "cannot open " << fileName.str() << std::endl;
         return;
       }
+      struct stat st;
+      fstat(fd,&st);
+      const size_t fileSize = st.st_size;
+      if (fileSize == 0) {
+        ::close(fd);
+        return;
+      }
+      const char* base = (const char*)mmap(NULL,fileSize,PROT_READ,MAP_SHARED,fd,0);
+      ::close(fd);
+      if (base == MAP_FAILED) {
+        std::cerr << "cannot mmap " << fileName.str() << std::endl;
+        return;
+      }
+      madvise((void*)base,fileSize,MADV_SEQUENTIAL);
 
-      // /* generate default material */
-      // Handle<Device::RTMaterial> defaultMaterial = g_device->rtNewMaterial("matte");
-      // g_device->rtSetFloat3(defaultMaterial, "reflectance", 0.5f, 0.5f, 0.5f);
-      // g_device->rtCommit(defaultMaterial);
       defaultMaterial = NULL;
-      curMaterial = defaultMaterial;
 
-      char line[1000000];
-      memset(line, 0, sizeof(line));
+      splitIntoChunks(base,base+fileSize);
 
-      while (cin.peek() != -1)
-        {
-          /* load next multiline */
-          char* pline = line;
-          while (true) {
-            cin.getline(pline, sizeof(line) - (pline - line) - 16, '\n');
-            ssize_t last = strlen(pline) - 1;
-            if (last < 0 || pline[last] != '\\') break;
-            pline += last;
-            *pline++ = ' ';
-          }
+      /* first pass: count attributes per chunk, so every chunk knows
+         where its attributes go in the global arrays */
+      OBJCountTask countTask(*this);
+      parallelFor(countTask,chunk.size());
 
-          const char* token = trimEnd(line + strspn(line, " \t"));
-          if (token[0] == 0) continue;
+      size_t numV = 0, numVN = 0, numVT = 0;
+      for (size_t i=0;i<chunk.size();i++) {
+        chunk[i]->baseV  = numV;  numV  += chunk[i]->numV;
+        chunk[i]->baseVN = numVN; numVN += chunk[i]->numVN;
+        chunk[i]->baseVT = numVT; numVT += chunk[i]->numVT;
+      }
+      v.resize(numV);
+      vn.resize(numVN);
+      vt.resize(numVT);
 
-          /*! parse position */
-          if (token[0] == 'v' && isSep(token[1]))                    { v.push_back(getVec3f(token += 2)); continue; }
+      /* materials have to be known before faces get grouped by them */
+      for (size_t i=0;i<chunk.size();i++)
+        for (size_t j=0;j<chunk[i]->mtllib.size();j++)
+          loadMTL(path + chunk[i]->mtllib[j]);
 
-          /* parse normal */
-          if (token[0] == 'v' && token[1] == 'n' && isSep(token[2])) { vn.push_back(getVec3f(token += 3)); continue; }
+      /* second pass: parse attributes and faces */
+      OBJParseTask parseTask(*this);
+      parallelFor(parseTask,chunk.size());
 
-          /* parse texcoord */
-          if (token[0] == 'v' && token[1] == 't' && isSep(token[2])) { vt.push_back(getVec2f(token += 3)); continue; }
+      munmap((void*)base,fileSize);
 
-          /*! parse face */
-          if (token[0] == 'f' && isSep(token[1]))
-            {
-              parseSep(token += 1);
+      collectFaceGroups();
 
-              std::vector<Vertex> face;
-              while (token[0]) {
-                face.push_back(getInt3(token));
-                parseSepOpt(token);
-              }
-              curGroup.push_back(face);
-              continue;
-            }
+      OBJMeshTask meshTask(*this);
+      parallelFor(meshTask,group.size());
+    }
 
-          /*! use material */
-          if (!strncmp(token, "usemtl", 6) && isSep(token[6]))
-            {
-              flushFaceGroup();
-              std::string name(parseSep(token += 6));
-              if (material.find(name) == material.end()) curMaterial = defaultMaterial;
-              else curMaterial = material[name];
-              continue;
-            }
+    OBJLoader::~OBJLoader()
+    {
+      for (size_t i=0;i<chunk.size();i++)
+        delete chunk[i];
+    }
 
-          /* load material library */
-          if (!strncmp(token, "mtllib", 6) && isSep(token[6])) {
-            loadMTL(path + std::string(parseSep(token += 6)));
-            continue;
+    /*! split [begin,end) into chunks of complete (logical) lines */
+    void OBJLoader::splitIntoChunks(const char* begin, const char* end)
+    {
+      const size_t minChunkSize = 1<<20;
+      const size_t maxNumChunks = 16*embree::getNumberOfLogicalThreads();
+      const size_t numChunks = std::max(size_t(1),
+                                        std::min(maxNumChunks,size_t(end-begin)/minChunkSize));
+      const size_t chunkSize = (end-begin)/numChunks;
+
+      const char* chunkBegin = begin;
+      while (chunkBegin < end) {
+        const char* chunkEnd = chunkBegin + chunkSize;
+        if (chunkEnd >= end || end - chunkEnd < (ssize_t)chunkSize/2)
+          chunkEnd = end;
+        else {
+          /* advance to the end of the current logical line */
+          const char* lineBegin = chunkEnd;
+          while (lineBegin > chunkBegin && lineBegin[-1] != '\n') --lineBegin;
+          while (chunkEnd < end) {
+            const char* lineEnd = findLineEnd(lineBegin,end);
+            chunkEnd = (lineEnd < end) ? lineEnd+1 : end;
+            if (!isContinued(lineBegin,lineEnd)) break;
+            lineBegin = chunkEnd;
           }
-      
+        }
+        chunk.push_back(new OBJChunk(chunkBegin,chunkEnd));
+        chunkBegin = chunkEnd;
+      }
+    }
+
+    void OBJLoader::countChunk(size_t chunkID)
+    {
+      OBJChunk& c = *chunk[chunkID];
+      std::string buffer;
+      const char *s = c.begin, *lb, *le;
+      while (nextLine(s,c.end,buffer,lb,le)) {
+        const char* t = lb;
+        skipSep(t,le);
+        switch (classifyLine(t,le)) {
+        case OBJ_V:      ++c.numV;  break;
+        case OBJ_VN:     ++c.numVN; break;
+        case OBJ_VT:     ++c.numVT; break;
+        case OBJ_MTLLIB: c.mtllib.push_back(getName(t,le)); break;
+        default: break;
+        }
+      }
+    }
+
+    void OBJLoader::parseChunk(size_t chunkID)
+    {
+      OBJChunk& c = *chunk[chunkID];
+      vec3f* myV  = v.empty()  ? NULL : &v[c.baseV];
+      vec3f* myVN = vn.empty() ? NULL : &vn[c.baseVN];
+      vec2f* myVT = vt.empty() ? NULL : &vt[c.baseVT];
+      size_t numV = 0, numVN = 0, numVT = 0;
+
+      std::string buffer;
+      const char *s = c.begin, *lb, *le;
+      while (nextLine(s,c.end,buffer,lb,le)) {
+        const char* t = lb;
+        skipSep(t,le);
+        switch (classifyLine(t,le)) {
+        case OBJ_V: {
+          const float x = parseFloat(t,le);
+          const float y = parseFloat(t,le);
+          const float z = parseFloat(t,le);
+          myV[numV++] = vec3f(x,y,z);
+        } break;
+        case OBJ_VN: {
+          const float x = parseFloat(t,le);
+          const float y = parseFloat(t,le);
+          const float z = parseFloat(t,le);
+          myVN[numVN++] = vec3f(x,y,z);
+        } break;
+        case OBJ_VT: {
+          const float x = parseFloat(t,le);
+          const float y = parseFloat(t,le);
+          myVT[numVT++] = vec2f(x,y);
+        } break;
+        case OBJ_F: {
+          skipSep(t,le);
+          while (t < le && *t != '\r') {
+            const char* prev = t;
+            c.corner.push_back(getInt3(t,le,c,numV,numVT,numVN));
+            skipSep(t,le);
+            if (t == prev) break; // garbage - ignore rest of line
+          }
+          c.faceOffset.push_back(c.corner.size());
+        } break;
+        case OBJ_USEMTL:
+          c.usemtl.push_back(std::make_pair(c.numFaces(),getName(t,le)));
+          break;
+        default:
           // ignore unknown stuff
+          break;
         }
-      flushFaceGroup();
-      cin.close();
+      }
     }
-    
-    OBJLoader::~OBJLoader()
+
+    /*! split the faces of all chunks into groups at each 'usemtl' */
+    void OBJLoader::collectFaceGroups()
     {
+      OBJFaceGroup cur;
+      cur.material = defaultMaterial;
+      cur.mesh     = NULL;
+      size_t curNumFaces = 0;
+
+      for (size_t i=0;i<chunk.size();i++) {
+        const OBJChunk& c = *chunk[i];
+        size_t faceBegin = 0;
+        for (size_t j=0;j<=c.usemtl.size();j++) {
+          const size_t faceEnd = (j < c.usemtl.size()) ? c.usemtl[j].first : c.numFaces();
+          if (faceEnd > faceBegin) {
+            OBJFaceRange range;
+            range.chunk = &c;
+            range.begin = faceBegin;
+            range.end   = faceEnd;
+            cur.range.push_back(range);
+            curNumFaces += faceEnd - faceBegin;
+          }
+          faceBegin = faceEnd;
+          if (j == c.usemtl.size()) break;
+
+          /* end current facegroup, and start a new one */
+          if (curNumFaces) group.push_back(cur);
+          cur.range.clear();
+          curNumFaces = 0;
+          const std::string& name = c.usemtl[j].second;
+          if (material.find(name) == material.end()) cur.material = defaultMaterial;
+          else cur.material = material[name];
+        }
+      }
+      if (curNumFaces) group.push_back(cur);
+
+      /* meshes and instances get created here, in file order; they
+         get filled in in parallel */
+      for (size_t i=0;i<group.size();i++) {
+        Mesh *mesh = new Mesh;
+        mesh->material = group[i].material;
+        model.mesh.push_back(mesh);
+        model.instance.push_back(Instance(model.mesh.size()-1));
+        group[i].mesh = mesh;
+      }
+    }
+
+    void OBJLoader::buildMesh(size_t groupID)
+    {
+      const OBJFaceGroup& g = group[groupID];
+      Mesh *mesh = g.mesh;
+
+      size_t numCorners = 0, numTriangles = 0;
+      for (size_t r=0;r<g.range.size();r++) {
+        const OBJChunk& c = *g.range[r].chunk;
+        for (size_t f=g.range[r].begin;f<g.range[r].end;f++) {
+          const size_t faceSize = c.faceOffset[f+1] - c.faceOffset[f];
+          numCorners += faceSize;
+          if (faceSize >= 3) numTriangles += faceSize-2;
+        }
+      }
+
+      /* merge three indices into one; 'INVALID' marks vertices that
+         are out of range or have NaN components */
+      const uint32 INVALID = uint32(-2);
+      /* in a closed triangle mesh each vertex is shared by about six
+         triangles, i.e., there are about numCorners/6 distinct
+         vertices; seams in texcoords or normals add some */
+      const size_t expectedNumUnique = numCorners/4;
+      VertexMap vertexMap(expectedNumUnique);
+      std::vector<Vertex> unique;
+      unique.reserve(expectedNumUnique);
+      bool hasNormals = false, hasTexcoords = false;
+
+      mesh->triangle.resize(numTriangles);
+      Triangle* tri = numTriangles ? &mesh->triangle[0] : NULL;
+      size_t numValid = 0;
+
+      for (size_t r=0;r<g.range.size();r++) {
+        const OBJChunk& c = *g.range[r].chunk;
+        for (size_t f=g.range[r].begin;f<g.range[r].end;f++) {
+          const Vertex* face = &c.corner[c.faceOffset[f]];
+          const size_t faceSize = c.faceOffset[f+1] - c.faceOffset[f];
+          if (faceSize < 3) continue;
+
+          uint32 id[3] = { INVALID, INVALID, INVALID };
+          /* triangulate the face with a triangle fan */
+          for (size_t k=0;k<faceSize;k++) {
+            const Vertex& i = face[k];
+            size_t slot = vertexMap.find(i);
+            uint32 vertexID = vertexMap.value[slot];
+            if (vertexID == VertexMap::EMPTY) {
+              bool valid = i.v >= 0 && i.v < (int)v.size()
+                && !std::isnan(v[i.v].x) && !std::isnan(v[i.v].y) && !std::isnan(v[i.v].z);
+              if (i.vn >= 0)
+                valid &= i.vn < (int)vn.size()
+                  && !std::isnan(vn[i.vn].x) && !std::isnan(vn[i.vn].y) && !std::isnan(vn[i.vn].z);
+              if (i.vt >= 0)
+                valid &= i.vt < (int)vt.size()
+                  && !std::isnan(vt[i.vt].x) && !std::isnan(vt[i.vt].y);
+              if (valid) {
+                vertexID = unique.size();
+                unique.push_back(i);
+                hasNormals   |= (i.vn >= 0);
+                hasTexcoords |= (i.vt >= 0);
+              } else
+                vertexID = INVALID;
+              vertexMap.insert(slot,i,vertexID);
+            }
+            if (k == 0) { id[0] = vertexID; continue; }
+            id[1] = id[2];
+            id[2] = vertexID;
+            if (k < 2) continue;
+            if (id[0] == INVALID || id[1] == INVALID || id[2] == INVALID)
+              continue;
+            tri[numValid].v0 = id[0];
+            tri[numValid].v1 = id[1];
+            tri[numValid].v2 = id[2];
+            ++numValid;
+          }
+        }
+      }
+      mesh->triangle.resize(numValid);
+
+      /* write the vertex arrays in one go */
+      const size_t numUnique = unique.size();
+      mesh->position.resize(numUnique);
+      for (size_t i=0;i<numUnique;i++)
+        mesh->position[i] = v[unique[i].v];
+      if (hasNormals) {
+        mesh->normal.resize(numUnique);
+        for (size_t i=0;i<numUnique;i++)
+          mesh->normal[i] = unique[i].vn >= 0 ? vec3fa(vn[unique[i].vn]) : vec3fa(0.f);
+      }
+      if (hasTexcoords) {
+        mesh->texcoord.resize(numUnique);
+        for (size_t i=0;i<numUnique;i++)
+          mesh->texcoord[i] = unique[i].vt >= 0 ? vt[unique[i].vt] : vec2f(0.f);
+      }
     }
 
     /* load material file */
     void OBJLoader::loadMTL(const embree::FileName &fileName)
     {
+      addImportDependency(fileName);
       std::ifstream cin;
       cin.open(fileName.c_str());
       if (!cin.is_open()) {
@@ -301,103 +854,48 @@ namespace ospray {
       cin.close();
     }
 
-    /*! handles relative indices and starts indexing from 0 */
-    int OBJLoader::fix_v (int index) { return(index > 0 ? index - 1 : (index == 0 ? 0 : (int) v .size() + index)); }
-    int OBJLoader::fix_vt(int index) { return(index > 0 ? index - 1 : (index == 0 ? 0 : (int) vt.size() + index)); }
-    int OBJLoader::fix_vn(int index) { return(index > 0 ? index - 1 : (index == 0 ? 0 : (int) vn.size() + index)); }
+
+    /*! skip the rest of an index token (like strcspn(token,"/ \t\r")) */
+    static inline void skipIndex(const char*& token, const char* end) {
+      while (token < end && !atTokenEnd(token,end)) ++token;
+    }
+
+    /*! handles relative indices and starts indexing from 0; 'base' and
+        'num' are the global index of the chunk's first attribute and
+        the number of attributes the chunk has defined so far */
+    static inline int fixIndex(int index, size_t base, size_t num) {
+      return(index > 0 ? index - 1 : (index == 0 ? 0 : (int)(base + num) + index));
+    }
 
     /*! Parse differently formated triplets like: n0, n0/n1/n2, n0//n2, n0/n1.          */
     /*! All indices are converted to C-style (from 0). Missing entries are assigned -1. */
-    Vertex OBJLoader::getInt3(const char*& token)
+    Vertex OBJLoader::getInt3(const char*& token, const char* end, const OBJChunk& c,
+                              size_t numV, size_t numVT, size_t numVN)
     {
-      Vertex v(-1);
-      v.v = fix_v(atoi(token));
-      token += strcspn(token, "/ \t\r");
-      if (token[0] != '/') return(v);
+      Vertex i(-1);
+      i.v = fixIndex(parseInt(token,end),c.baseV,numV);
+      skipIndex(token,end);
+      if (token >= end || token[0] != '/') return(i);
       token++;
 
       // it is i//n
-      if (token[0] == '/') {
+      if (token < end && token[0] == '/') {
         token++;
-        v.vn = fix_vn(atoi(token));
-        token += strcspn(token, " \t\r");
-        return(v);
+        i.vn = fixIndex(parseInt(token,end),c.baseVN,numVN);
+        skipIndex(token,end);
+        return(i);
       }
 
       // it is i/t/n or i/t
-      v.vt = fix_vt(atoi(token));
-      token += strcspn(token, "/ \t\r");
-      if (token[0] != '/') return(v);
+      i.vt = fixIndex(parseInt(token,end),c.baseVT,numVT);
+      skipIndex(token,end);
+      if (token >= end || token[0] != '/') return(i);
       token++;
 
       // it is i/t/n
-      v.vn = fix_vn(atoi(token));
-      token += strcspn(token, " \t\r");
-      return(v);
-    }
-
-    uint32 OBJLoader::getVertex(std::map<Vertex,uint32>& vertexMap, 
-                                Mesh *mesh, const Vertex& i)
-    {
-      const std::map<Vertex, uint32>::iterator& entry = vertexMap.find(i);
-      if (entry != vertexMap.end()) return(entry->second);
-
-      if (std::isnan(v[i.v].x) || std::isnan(v[i.v].y) || std::isnan(v[i.v].z))
-        return -1;
-
-      if (i.vn >= 0 && (std::isnan(vn[i.vn].x) ||
-                        std::isnan(vn[i.vn].y) ||
-                        std::isnan(vn[i.vn].z)))
-        return -1;
-
-      if (i.vt >= 0 && (std::isnan(vt[i.vt].x) ||
-                        std::isnan(vt[i.vt].y)))
-        return -1;
-
-      mesh->position.push_back(v[i.v]);
-      if (i.vn >= 0) mesh->normal.push_back(vn[i.vn]);
-      if (i.vt >= 0) mesh->texcoord.push_back(vt[i.vt]);
-      return(vertexMap[i] = int(mesh->position.size()) - 1);
-    }
-
-    /*! end current facegroup and append to mesh */
-    void OBJLoader::flushFaceGroup()
-    {
-      if (curGroup.empty()) return;
-
-      // temporary data arrays
-      // std::vector<vec3fa> &positions = ;
-      // std::vector<vec3fa> &normals;
-      // std::vector<vec2f> &texcoords;
-      // std::vector<Triangle> &triangles;
-      std::map<Vertex, uint32> vertexMap;
-      Mesh *mesh = new Mesh;
-      model.mesh.push_back(mesh);
-      model.instance.push_back(Instance(model.mesh.size()-1));
-      mesh->material = curMaterial;
-      // merge three indices into one
-      for (size_t j=0; j < curGroup.size(); j++)
-        {
-          /* iterate over all faces */
-          const std::vector<Vertex>& face = curGroup[j];
-          Vertex i0 = face[0], i1 = Vertex(-1), i2 = face[1];
-          
-          /* triangulate the face with a triangle fan */
-          for (size_t k=2; k < face.size(); k++) {
-            i1 = i2; i2 = face[k];
-            int32 v0 = getVertex(vertexMap, mesh, i0);
-            int32 v1 = getVertex(vertexMap, mesh, i1);
-            int32 v2 = getVertex(vertexMap, mesh, i2);
-            if (v0 < 0 || v1 < 0 || v2 < 0)
-              continue;
-            Triangle tri;
-            tri.v0 = v0;
-            tri.v1 = v1;
-            tri.v2 = v2;
-            mesh->triangle.push_back(tri); //Vec3i(v0, v1, v2));
-          }
-        }
-      curGroup.clear();
+      i.vn = fixIndex(parseInt(token,end),c.baseVN,numVN);
+      skipIndex(token,end);
+      return(i);
     }
 
     void importOBJ(Model &model,
@@ -410,5 +908,3 @@ namespace ospray {
 
   } // ::ospray::minisg
 } // ::ospray
-
-
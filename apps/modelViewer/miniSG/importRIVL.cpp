@@ -585,6 +585,7 @@ namespace ospray {
     {
       string xmlFileName = fileName;
       string binFileName = fileName+".bin";
+      addImportDependency(binFileName);
 
       FILE *file = fopen(binFileName.c_str(),"r");
       if (!file)
@@ -32,8 +32,57 @@ namespace ospray {
       , width(0)
       , height(0)
       , data(NULL)
+      , blockFormat(OSP_UNKNOWN)
     {}
 
+    size_t Texture2D::numBytes() const
+    {
+      if (blockFormat != OSP_UNKNOWN)
+        return sizeOf(blockFormat)*((width+3)/4)*((height+3)/4);
+      return size_t(width)*height*channels*depth;
+    }
+
+    /*! loads the first mip level of a DXT1/DXT5 compressed DDS file as
+        a BC1/BC3 texture; the blocks are passed on as they are */
+    static Texture2D *loadDDS(const embree::FileName &fileName)
+    {
+      FILE *file = fopen(fileName.str().c_str(),"rb");
+      if (!file)
+        throw std::runtime_error("#osp:miniSG: could not open texture file '"+fileName.str()+"'.");
+
+      unsigned char header[128];
+      if (fread(header,sizeof(header),1,file) != 1 || memcmp(header,"DDS ",4)) {
+        fclose(file);
+        throw std::runtime_error("#osp:miniSG: '"+fileName.str()+"' is not a DDS file.");
+      }
+      uint32 height, width;
+      memcpy(&height,header+12,4);
+      memcpy(&width,header+16,4);
+
+      OSPDataType blockFormat = OSP_UNKNOWN;
+      if (!memcmp(header+84,"DXT1",4)) blockFormat = OSP_BC1;
+      if (!memcmp(header+84,"DXT5",4)) blockFormat = OSP_BC3;
+      if (blockFormat == OSP_UNKNOWN) {
+        fclose(file);
+        throw std::runtime_error("#osp:miniSG: can currently load only DXT1 and DXT5 DDS texture files ('"
+                                 +fileName.str()+"').");
+      }
+
+      Texture2D *tex = new Texture2D;
+      tex->width       = width;
+      tex->height      = height;
+      tex->blockFormat = blockFormat;
+      tex->data        = new unsigned char[tex->numBytes()];
+      const size_t rc = fread(tex->data,tex->numBytes(),1,file);
+      fclose(file);
+      if (rc != 1) {
+        delete[] (unsigned char *)tex->data;
+        delete tex;
+        throw std::runtime_error("#osp:miniSG: truncated DDS file '"+fileName.str()+"'.");
+      }
+      return tex;
+    }
+
     Material::Material()
     {
       // setParam( "Kd", vec3f(.7f) );
@@ -44,6 +93,7 @@ namespace ospray {
     Texture2D *loadTexture(const std::string &path, const std::string &fileNameBase)
     {
       const embree::FileName fileName = path+"/"+fileNameBase;
+      addImportDependency(fileName);
 
       static std::map<std::string,Texture2D*> textureCache;
       if (textureCache.find(fileName.str()) != textureCache.end()) 
@@ -114,6 +164,12 @@ namespace ospray {
         } catch(std::runtime_error e) {
           std::cerr << e.what() << std::endl;
         }
+      } else if (ext == "dds") {
+        try {
+          tex = loadDDS(fileName);
+        } catch(std::runtime_error e) {
+          std::cerr << e.what() << std::endl;
+        }
       } else {
 #ifdef USE_IMAGEMAGICK
         Magick::Image image(fileName.str().c_str());
@@ -40,6 +40,13 @@ namespace ospray {
       int width;    //Pixels per row
       int height;   //Pixels per column
       void *data;   //Pointer to binary texture data
+      /*! OSP_BC1 or OSP_BC3 if 'data' holds the 4x4 blocks of a
+          compressed texture (then channels and depth are unused),
+          OSP_UNKNOWN otherwise */
+      OSPDataType blockFormat;
+
+      //! size of 'data' in bytes
+      size_t numBytes() const;
     };
     
     Texture2D *loadTexture(const std::string &path, const std::string &fileName);
@@ -253,6 +260,26 @@ namespace ospray {
     /*! import a MiniSG MSG file, and add it to the specified model */
     void importMSG(Model &model, const embree::FileName &fileName);
 
+    /*! write the specified model to a (binary) MiniSG MSG file */
+    void exportMSG(Model &model, const embree::FileName &fileName);
+
+    /*! signature of the importers above that import a single file into a model */
+    typedef void (*Importer)(Model &model, const embree::FileName &fileName);
+
+    /*! import a file through the given importer, using a binary MSG
+        cache file ('<fileName>.msg') next to it: if the cache exists
+        and matches the file's size and modification time, the model
+        gets loaded from the cache; otherwise the file gets imported
+        and the cache (re-)written. The cache also gets invalidated if
+        any file the importer registered via addImportDependency()
+        changed. */
+    void importCached(Model &model, const embree::FileName &fileName, Importer importer);
+
+    /*! to be called by importers for each file they read besides the
+        one they were asked to import (material libraries, textures,
+        ...), such that importCached() can tell when a cache is stale */
+    void addImportDependency(const embree::FileName &fileName);
+
     void error(const std::string &err);
 
   } // ::ospray::minisg
@@ -36,9 +36,21 @@ namespace ospray {
   int g_benchWarmup = 0, g_benchFrames = 0;
   bool g_alpha = false;
   bool g_createDefaultMaterial = true;
+  /*! whether to load/store imported models through a binary '.msg'
+      cache file next to the input file (cmdline: --no-model-cache) */
+  bool g_useModelCache = true;
+  /*! whether to have ospray block-compress 8-bit textures (cmdline:
+      --compress-textures) */
+  bool g_compressTextures = false;
   int accumID = -1;
   int maxAccum = 64;
   int spp = 1; /*! number of samples per pixel */
+  /*! target frame time (in seconds) while the camera moves, 0 for
+      none (cmdline: --frame-time-budget <ms>) */
+  float frameTimeBudget = 0.f;
+  /*! whether to reproject the accumulated image while the camera
+      moves, rather than starting over (cmdline: --reproject) */
+  bool reproject = false;
   unsigned int maxObjectsToConsider = (uint32)-1;
   // if turned on, we'll put each triangle mesh into its own instance, no matter what
   bool forceInstancing = false;
@@ -92,6 +104,7 @@ namespace ospray {
       ospSetObject(renderer,"model",model);
       ospSetObject(renderer,"camera",camera);
       ospSet1i(renderer,"spp",spp);
+      ospSet1f(renderer,"frameTimeBudget",frameTimeBudget);
       ospCommit(camera);
       ospCommit(renderer);
       
@@ -101,7 +114,8 @@ namespace ospray {
     {
       Glut3DWidget::reshape(newSize);
       if (fb) ospFreeFrameBuffer(fb);
-      fb = ospNewFrameBuffer(newSize,OSP_RGBA_I8,OSP_FB_COLOR|OSP_FB_DEPTH|OSP_FB_ACCUM);
+      fb = ospNewFrameBuffer(newSize,OSP_RGBA_I8,OSP_FB_COLOR|OSP_FB_DEPTH|OSP_FB_ACCUM
+                             |(reproject ? OSP_FB_HISTORY : 0));
       ospFrameBufferClear(fb,OSP_FB_ACCUM);
       ospSetf(camera,"aspect",viewPort.aspect);
       ospCommit(camera);
@@ -122,7 +136,8 @@ namespace ospray {
         ospSet1i(renderer,"shadowsEnabled",doShadows);
         ospCommit(renderer);
         accumID=0;
-        ospFrameBufferClear(fb,OSP_FB_ACCUM);
+        // the history shows the old shading, too
+        ospFrameBufferClear(fb,OSP_FB_ACCUM|OSP_FB_HISTORY);
         forceRedraw();
         break;
       case 'D':
@@ -361,12 +376,14 @@ namespace ospray {
       if( msgTex->channels == 3 ) type = OSP_FLOAT3;
       if( msgTex->channels == 4 ) type = OSP_FLOAT3A;
     }
+    if (msgTex->blockFormat != OSP_UNKNOWN)
+      type = msgTex->blockFormat;
 
     OSPTexture2D ospTex = ospNewTexture2D( msgTex->width,
                                            msgTex->height,
                                            type,
                                            msgTex->data,
-                                           0);
+                                           g_compressTextures ? OSP_TEXTURE_COMPRESS : 0);
     
     alreadyCreatedTextures[msgTex] = ospTex;
 
@@ -456,6 +473,10 @@ namespace ospray {
         maxObjectsToConsider = atoi(av[++i]);
       } else if (arg == "--spp") {
         spp = atoi(av[++i]);
+      } else if (arg == "--frame-time-budget") {
+        frameTimeBudget = atof(av[++i]) * 1e-3f;
+      } else if (arg == "--reproject") {
+        reproject = true;
       } else if (arg == "--force-instancing") {
         forceInstancing = true;
       } else if (arg == "--pt") {
@@ -507,25 +528,36 @@ namespace ospray {
           }
       } else if (arg == "--no-default-material") {
         g_createDefaultMaterial = false;
+      } else if (arg == "--no-model-cache") {
+        g_useModelCache = false;
+      } else if (arg == "--compress-textures") {
+        g_compressTextures = true;
       } else if (av[i][0] == '-') {
         error("unkown commandline argument '"+arg+"'");
       } else {
         embree::FileName fn = arg;
+        miniSG::Importer importer = NULL;
         if (fn.ext() == "stl") {
-          miniSG::importSTL(*msgModel,fn);
+          importer = miniSG::importSTL;
         } else if (fn.ext() == "msg") {
           miniSG::importMSG(*msgModel,fn);
         } else if (fn.ext() == "tri") {
-          miniSG::importTRI(*msgModel,fn);
+          importer = miniSG::importTRI;
         } else if (fn.ext() == "xml") {
-          miniSG::importRIVL(*msgModel,fn);
+          importer = miniSG::importRIVL;
         } else if (fn.ext() == "obj") {
-          miniSG::importOBJ(*msgModel,fn);
+          importer = miniSG::importOBJ;
         } else if (fn.ext() == "x3d") {
-          miniSG::importX3D(*msgModel,fn); 
+          importer = miniSG::importX3D;
         } else if (fn.ext() == "astl") {
           miniSG::importSTL(msgAnimation,fn);
         }
+        if (importer) {
+          if (g_useModelCache)
+            miniSG::importCached(*msgModel,fn,importer);
+          else
+            importer(*msgModel,fn);
+        }
       }
     }
 
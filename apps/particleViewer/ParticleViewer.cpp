@@ -40,6 +40,9 @@ namespace ospray {
     std::vector<OSPModel> modelTimeStep;
 
     std::string modelSaveFileName = "";
+    /*! whether to use the compressed 'quantized_spheres' geometry
+        (cmdline: --quantize) */
+    bool quantize = false;
     OSPRenderer        ospRenderer = NULL;
     typedef enum { LAMMPS_XYZ, DAT_XYZ } InputFormat;
 
@@ -217,6 +220,71 @@ namespace ospray {
       return data;
     }
 
+    /*! release callback for arrays handed over via ospNewSharedData */
+    template<typename T>
+    void deleteArray(void *array, void *)
+    {
+      delete[] (T*)array;
+    }
+
+    /*! create a 'quantized_spheres' geometry for the given model:
+        atoms are grouped into blocks of 'spheresPerBlock' consecutive
+        atoms, and each atom's position is stored as 16-bit offsets
+        relative to its block's bounding box */
+    OSPGeometry makeQuantizedSpheres(particle::Model *model)
+    {
+      const size_t spheresPerBlock = 65536;
+      const size_t numAtoms  = model->atom.size();
+      const size_t numBlocks = divRoundUp(numAtoms,spheresPerBlock);
+
+      uint16 *positions  = new uint16[3*numAtoms];
+      uint8  *attributes = new uint8[numAtoms];
+      vec4f  *blocks     = new vec4f[numBlocks];
+
+      for (size_t blockID=0;blockID<numBlocks;blockID++) {
+        const size_t begin = blockID*spheresPerBlock;
+        const size_t end   = std::min(begin+spheresPerBlock,numAtoms);
+        box3f bounds = embree::empty;
+        for (size_t i=begin;i<end;i++)
+          bounds.extend(model->atom[i].position);
+
+        const vec3f extent = bounds.size();
+        const float maxExtent = std::max(extent.x,std::max(extent.y,extent.z));
+        const float step = maxExtent > 0.f ? maxExtent/65535.f : 1.f;
+        blocks[blockID] = vec4f(bounds.lower.x,bounds.lower.y,bounds.lower.z,step);
+
+        for (size_t i=begin;i<end;i++) {
+          const vec3f q = (model->atom[i].position - bounds.lower) * (1.f/step) + vec3f(.5f);
+          positions[3*i+0] = (uint16)std::min(q.x,65535.f);
+          positions[3*i+1] = (uint16)std::min(q.y,65535.f);
+          positions[3*i+2] = (uint16)std::min(q.z,65535.f);
+          attributes[i] = (uint8)model->atom[i].type;
+        }
+      }
+
+      if (model->atomType.size() > 256)
+        cout << "#osp:particleViewer: warning - more than 256 atom types, "
+             << "material IDs will be truncated to 8 bits" << endl;
+
+      // hand the arrays over to ospray rather than copying them
+      OSPData positionData = ospNewSharedData(numAtoms,OSP_USHORT3,positions,
+                                              deleteArray<uint16>);
+      OSPData blockData = ospNewSharedData(numBlocks,OSP_FLOAT4,blocks,
+                                           deleteArray<vec4f>);
+      OSPData attributeData = ospNewSharedData(numAtoms,OSP_UCHAR,attributes,
+                                               deleteArray<uint8>);
+      ospCommit(positionData);
+      ospCommit(blockData);
+      ospCommit(attributeData);
+
+      OSPGeometry geom = ospNewGeometry("quantized_spheres");
+      ospSet1i(geom,"spheres_per_block",spheresPerBlock);
+      ospSetData(geom,"positions",positionData);
+      ospSetData(geom,"blocks",blockData);
+      ospSetData(geom,"attributes",attributeData);
+      return geom;
+    }
+
     void ospParticleViewerMain(int &ac, const char **&av)
     {
       std::vector<Model *> particleModel;
@@ -243,6 +311,8 @@ namespace ospray {
           ospLoadModule(moduleName);
         } else if (arg == "--show-fps") {
           showFPS = true;
+        } else if (arg == "--quantize") {
+          quantize = true;
         } else if (arg == "--save-to") {
           modelSaveFileName = av[++i];
         } else if (av[i][0] == '-') {
@@ -304,16 +374,21 @@ namespace ospray {
         OSPModel model = ospNewModel();
         OSPData materialData = makeMaterials(ospRenderer,particleModel[i]);
     
-        OSPData data = ospNewData(particleModel[i]->atom.size()*4,OSP_FLOAT,
-                                  &particleModel[i]->atom[0],OSP_DATA_SHARED_BUFFER);
-        ospCommit(data);
-
-        OSPGeometry geom = ospNewGeometry("spheres");
+        OSPGeometry geom = NULL;
+        if (quantize) {
+          geom = makeQuantizedSpheres(particleModel[i]);
+        } else {
+          OSPData data = ospNewData(particleModel[i]->atom.size()*4,OSP_FLOAT,
+                                    &particleModel[i]->atom[0],OSP_DATA_SHARED_BUFFER);
+          ospCommit(data);
+
+          geom = ospNewGeometry("spheres");
+          ospSet1i(geom,"bytes_per_sphere",sizeof(Model::Atom));
+          ospSet1i(geom,"center_offset",0);
+          ospSet1i(geom,"offset_materialID",3*sizeof(float));
+          ospSetData(geom,"spheres",data);
+        }
         ospSet1f(geom,"radius",radius*particleModel[i]->radius);
-        ospSet1i(geom,"bytes_per_sphere",sizeof(Model::Atom));
-        ospSet1i(geom,"center_offset",0);
-        ospSet1i(geom,"offset_materialID",3*sizeof(float));
-        ospSetData(geom,"spheres",data);
         ospSetData(geom,"materialList",materialData);
         ospCommit(geom);
 
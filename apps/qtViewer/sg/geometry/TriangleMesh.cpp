@@ -102,7 +102,8 @@ namespace ospray {
       for(size_t i = 0; i < index->getSize(); i++) {
         materialIDs.push_back(triangles[i].materialID >> 16);
       }
-      primMatIDs = ospNewData(materialIDs.size(), OSP_INT, &materialIDs[0], 0);
+      primMatIDs = ospNewData(materialIDs.size(), OSP_INT, &materialIDs[0],
+                              OSP_DATA_SHARED_BUFFER);
       ospSetData(ospGeometry,"prim.materialID",primMatIDs);
       
       // assign a default material (for now.... eventually we might
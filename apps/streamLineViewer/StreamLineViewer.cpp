@@ -503,8 +503,10 @@ namespace ospray {
       if (sl && !sl->index.empty()) {
         OSPGeometry geom = ospNewGeometry("streamlines");
         Assert(geom);
-        OSPData vertex = ospNewData(sl->vertex.size(),OSP_FLOAT3A,&sl->vertex[0]);
-        OSPData index  = ospNewData(sl->index.size(),OSP_UINT,&sl->index[0]);
+        OSPData vertex = ospNewData(sl->vertex.size(),OSP_FLOAT3A,&sl->vertex[0],
+                                      OSP_DATA_SHARED_BUFFER);
+        OSPData index  = ospNewData(sl->index.size(),OSP_UINT,&sl->index[0],
+                                      OSP_DATA_SHARED_BUFFER);
         ospSetObject(geom,"vertex",vertex);
         ospSetObject(geom,"index",index);
         ospSet1f(geom,"radius",sl->radius);
@@ -517,9 +519,12 @@ namespace ospray {
       if (tris && !tris->index.empty()) {
         OSPGeometry geom = ospNewTriangleMesh();
         Assert(geom);
-        OSPData vertex = ospNewData(tris->vertex.size(),OSP_FLOAT3A,&tris->vertex[0]);
-        OSPData index  = ospNewData(tris->index.size(),OSP_INT3,&tris->index[0]);
-        OSPData color  = ospNewData(tris->color.size(),OSP_FLOAT3A,&tris->color[0]);
+        OSPData vertex = ospNewData(tris->vertex.size(),OSP_FLOAT3A,&tris->vertex[0],
+                                      OSP_DATA_SHARED_BUFFER);
+        OSPData index  = ospNewData(tris->index.size(),OSP_INT3,&tris->index[0],
+                                      OSP_DATA_SHARED_BUFFER);
+        OSPData color  = ospNewData(tris->color.size(),OSP_FLOAT3A,&tris->color[0],
+                                      OSP_DATA_SHARED_BUFFER);
         ospSetObject(geom,"vertex",vertex);
         ospSetObject(geom,"index",index);
         ospSetObject(geom,"vertex.color",color);
@@ -547,7 +552,8 @@ namespace ospray {
           spheres[i] = ospNewGeometry("spheres");
           Assert(spheres[i]);
 
-          OSPData data = ospNewData(swc->spheres[i].size(), OSP_FLOAT4, &swc->spheres[i][0]);
+          OSPData data = ospNewData(swc->spheres[i].size(), OSP_FLOAT4, &swc->spheres[i][0],
+                                    OSP_DATA_SHARED_BUFFER);
           ospSetObject(spheres[i], "spheres", data);
           ospSet1i(spheres[i], "offset_radius", 3*sizeof(float));
  
@@ -561,7 +567,8 @@ namespace ospray {
           cylinders[i] = ospNewGeometry("cylinders");
           Assert(cylinders[i]);
 
-          data = ospNewData(swc->cylinders[i].size()*7, OSP_FLOAT, &swc->cylinders[i][0]);
+          data = ospNewData(swc->cylinders[i].size()*7, OSP_FLOAT, &swc->cylinders[i][0],
+                            OSP_DATA_SHARED_BUFFER);
           ospSetObject(cylinders[i], "cylinders", data);
  
           if (material[i])
@@ -34,6 +34,11 @@ PreferencesDialog::PreferencesDialog(VolumeViewer *volumeViewer, osp::box3f boun
   connect(gradientShadingEnabledCheckBox, SIGNAL(toggled(bool)), volumeViewer, SLOT(setGradientShadingEnabled(bool)));
   formLayout->addRow("Volume gradient shading", gradientShadingEnabledCheckBox);
 
+  // precomputed gradients flag
+  QCheckBox *precomputedGradientsEnabledCheckBox = new QCheckBox();
+  connect(precomputedGradientsEnabledCheckBox, SIGNAL(toggled(bool)), volumeViewer, SLOT(setPrecomputedGradientsEnabled(bool)));
+  formLayout->addRow("Precomputed gradients", precomputedGradientsEnabledCheckBox);
+
   // sampling rate selection
   QDoubleSpinBox *samplingRateSpinBox = new QDoubleSpinBox();
   samplingRateSpinBox->setDecimals(3);
@@ -81,6 +86,7 @@ PreferencesDialog::PreferencesDialog(VolumeViewer *volumeViewer, osp::box3f boun
   // set default values. this will trigger signal / slot executions.
   subsamplingInteractionEnabledCheckBox->setChecked(false);
   gradientShadingEnabledCheckBox->setChecked(false);
+  precomputedGradientsEnabledCheckBox->setChecked(false);
   samplingRateSpinBox->setValue(0.125);
 }
 
@@ -0,0 +1,196 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include <algorithm>
+#include "modules/loaders/ObjectFile.h"
+#include "TimeStepLoader.h"
+
+void TimeStep::release()
+{
+  for (size_t i=0 ; i < volumes.size() ; i++)
+    ospRelease(volumes[i]);
+
+  if (model != NULL)
+    ospRelease(model);
+
+  model = NULL;
+  volumes.clear();
+}
+
+TimeStepLoader::TimeStepLoader(const std::vector<std::string> &filenames, OSPTransferFunction transferFunction)
+  : filenames(filenames),
+    transferFunction(transferFunction),
+    loading(0),
+    busy(false),
+    stopping(false)
+{
+  start();
+}
+
+TimeStepLoader::~TimeStepLoader()
+{
+  //! Stop the loader thread after the time step it is reading, if any.
+  mutex.lock();
+  stopping = true;
+  queued.wakeAll();
+  mutex.unlock();
+  wait();
+}
+
+void TimeStepLoader::prefetch(size_t index)
+{
+  if (index >= filenames.size())
+    return;
+
+  QMutexLocker lock(&mutex);
+
+  if ((busy && loading == index) || staged.count(index) || std::find(queue.begin(), queue.end(), index) != queue.end())
+    return;
+
+  queue.push_back(index);
+  queued.wakeOne();
+}
+
+TimeStep TimeStepLoader::acquire(size_t index)
+{
+  if (index >= filenames.size())
+    return(TimeStep());
+
+  QMutexLocker lock(&mutex);
+
+  //! Read the files on the calling thread rather than after the time steps queued before it.
+  std::deque<size_t>::iterator it = std::find(queue.begin(), queue.end(), index);
+  if (it != queue.end())
+    queue.erase(it);
+
+  //! Wait for the files if they are being read.
+  while (busy && loading == index)
+    finished.wait(&mutex);
+
+  staged.erase(index);
+  lock.unlock();
+
+  //! Create and commit the OSPRay objects here, on the thread rendering them.
+  return(load(index));
+}
+
+bool TimeStepLoader::isStaged(size_t index)
+{
+  QMutexLocker lock(&mutex);
+  return(staged.count(index) > 0);
+}
+
+void TimeStepLoader::discard(size_t index)
+{
+  QMutexLocker lock(&mutex);
+
+  std::deque<size_t>::iterator it = std::find(queue.begin(), queue.end(), index);
+  if (it != queue.end())
+    queue.erase(it);
+
+  staged.erase(index);
+}
+
+void TimeStepLoader::stage(size_t index) const
+{
+  //! The object file and the volume data files it references, relative to the object file unless absolute.
+  const QFileInfo objectFile(QString::fromLocal8Bit(filenames[index].c_str()));
+  QStringList files(objectFile.absoluteFilePath());
+
+  QFile file(objectFile.absoluteFilePath());
+  if (file.open(QIODevice::ReadOnly)) {
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+      if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("filename")) continue;
+      const QString name = xml.readElementText().trimmed();
+      files.append(QFileInfo(name).isAbsolute() ? name : objectFile.absoluteDir().filePath(name));
+    }
+  }
+
+  //! Read the files into the page cache, the importers then read them from memory.
+  std::vector<char> buffer(1 << 20);
+  for (int i=0 ; i < files.size() ; i++) {
+    QFile data(files[i]);
+    if (!data.open(QIODevice::ReadOnly)) continue;
+    while (data.read(&buffer[0], buffer.size()) > 0);
+  }
+}
+
+TimeStep TimeStepLoader::load(size_t index) const
+{
+  TimeStep timeStep;
+
+  //! Create an OSPRay model.
+  timeStep.model = ospNewModel();
+
+  //! Load OSPRay objects from a file.
+  OSPObject *objects = ObjectFile::importObjects(filenames[index].c_str());
+
+  //! Iterate over the volumes contained in the object list.
+  for (size_t i=0 ; objects[i] ; i++) {
+    OSPDataType type;
+    ospGetType(objects[i], NULL, &type);
+
+    if (type == OSP_VOLUME) {
+
+      //! For now we set the same transfer function on all volumes.
+      ospSetObject(objects[i], "transferFunction", transferFunction);
+      ospCommit(objects[i]);
+
+      //! Add the loaded volume(s) to the model.
+      ospAddVolume(timeStep.model, (OSPVolume) objects[i]);
+
+      //! Keep a vector of all loaded volume(s).
+      timeStep.volumes.push_back((OSPVolume) objects[i]);
+    }
+  }
+
+  //! Commit the model.
+  ospCommit(timeStep.model);
+
+  return(timeStep);
+}
+
+void TimeStepLoader::run()
+{
+  for (;;) {
+
+    //! Wait for a queued time step.
+    mutex.lock();
+    while (queue.empty() && !stopping)
+      queued.wait(&mutex);
+
+    if (stopping) {
+      mutex.unlock();
+      return;
+    }
+
+    loading = queue.front();
+    queue.pop_front();
+    busy = true;
+    mutex.unlock();
+
+    //! Read the files of the time step without holding the lock.
+    stage(loading);
+
+    mutex.lock();
+    staged.insert(loading);
+    busy = false;
+    finished.wakeAll();
+    mutex.unlock();
+  }
+}
@@ -0,0 +1,116 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+#include <QtCore>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+#include <ospray/ospray.h>
+
+//! The OSPRay objects of one time step.
+struct TimeStep {
+
+  //! Constructor.
+  TimeStep() : model(NULL) {}
+
+  //! Model containing the volumes of the time step, NULL if the time step is not loaded.
+  OSPModel model;
+
+  //! Volumes contained in the model.
+  std::vector<OSPVolume> volumes;
+
+  //! Release the OSPRay objects of the time step.
+  void release();
+
+};
+
+//! \brief Loads time steps from OSPRay object files, reading the files
+//!  of upcoming time steps on a background thread while the current
+//!  one is displayed.
+//!
+//!  The loader thread only does file I/O: it reads the object file and
+//!  the volume data files it references so they are resident in the
+//!  page cache. The OSPRay objects are created, filled and committed in
+//!  acquire(), on the thread which renders them, since OSPRay objects
+//!  must not be modified while a frame is being rendered. That thread
+//!  acquires staged time steps between frames, ahead of their display.
+//!
+class TimeStepLoader : public QThread {
+
+public:
+
+  //! Constructor, the transfer function is set on all loaded volumes.
+  TimeStepLoader(const std::vector<std::string> &filenames, OSPTransferFunction transferFunction);
+
+  //! Destructor, stops the loader thread.
+  ~TimeStepLoader();
+
+  //! Queue the files of a time step for reading in the background, unless they are already read or queued.
+  void prefetch(size_t index);
+
+  //! Create the OSPRay objects of a time step on the calling thread, waiting for its files if they are being read.
+  //! Ownership of the objects passes to the caller, an empty time step is returned for an invalid index.
+  TimeStep acquire(size_t index);
+
+  //! Whether the files of a time step have been read, such that acquire() does not wait for them.
+  bool isStaged(size_t index);
+
+  //! Drop a time step from the queue and forget it was read.
+  void discard(size_t index);
+
+protected:
+
+  //! OSPRay object file filenames, one for each time step.
+  std::vector<std::string> filenames;
+
+  //! Transfer function set on all loaded volumes.
+  OSPTransferFunction transferFunction;
+
+  //! Guards all members below.
+  QMutex mutex;
+
+  //! Signaled when a time step is queued or the loader is stopped.
+  QWaitCondition queued;
+
+  //! Signaled when the files of a time step have been read.
+  QWaitCondition finished;
+
+  //! Time steps waiting to be read.
+  std::deque<size_t> queue;
+
+  //! The time step being read on the loader thread, if 'busy' is set.
+  size_t loading;  bool busy;
+
+  //! Time steps read on the loader thread but not yet acquired.
+  std::set<size_t> staged;
+
+  //! Set to stop the loader thread.
+  bool stopping;
+
+  //! Read the object file of a time step and the data files it references, without creating OSPRay objects.
+  void stage(size_t index) const;
+
+  //! Create the OSPRay objects of a time step from its object file.
+  TimeStep load(size_t index) const;
+
+  //! Read queued time steps until the loader is stopped.
+  void run();
+
+};
@@ -15,7 +15,6 @@
 // ======================================================================== //
 
 #include <algorithm>
-#include "modules/loaders/ObjectFile.h"
 #include "VolumeViewer.h"
 #include "TransferFunctionEditor.h"
 #include "IsosurfaceEditor.h"
@@ -26,9 +25,19 @@
 
 VolumeViewer::VolumeViewer(const std::vector<std::string> &objectFileFilenames,
                            bool showFrameRate,
-                           std::string writeFramesFilename)
+                           std::string writeFramesFilename,
+                           size_t timeStepWindow)
   : objectFileFilenames(objectFileFilenames),
+    timeSteps(objectFileFilenames.size()),
+    timeStepWindow(timeStepWindow == 0 ? objectFileFilenames.size() : std::min(timeStepWindow, objectFileFilenames.size())),
+    currentTimeStep(0),
+    timeStepLoader(NULL),
     dynamicModel(NULL),
+    gradientShadingEnabled(-1),
+    precomputedGradientsEnabled(-1),
+    samplingRate(-1.f),
+    volumeClippingBoxSet(false),
+    isovaluesData(NULL),
     boundingBox(osp::vec3f(0.f), osp::vec3f(1.f)),
     renderer(NULL),
     rendererInitialized(false),
@@ -60,15 +69,43 @@ VolumeViewer::VolumeViewer(const std::vector<std::string> &objectFileFilenames,
   show();
 }
 
+VolumeViewer::~VolumeViewer()
+{
+  //! Stop loading time steps in the background.
+  delete timeStepLoader;
+}
+
 void VolumeViewer::setModel(size_t index)
 {
-  //! Set current model on the OSPRay renderer.
-  ospSetObject(renderer, "model", models[index]);
+  //! Nothing to display without time steps.
+  if (index >= timeSteps.size())
+    return;
+
+  //! Release the time steps outside the window, which starts at the selected time step and wraps around.
+  for (size_t i=0 ; i < timeSteps.size() ; i++) {
+    if ((i + timeSteps.size() - index) % timeSteps.size() < timeStepWindow) continue;
+    timeStepLoader->discard(i);
+    timeSteps[i].release();
+  }
+
+  //! The selected time step is needed now, the following ones in the window are loaded in the background.
+  if (timeSteps[index].model == NULL)
+    adoptTimeStep(index, timeStepLoader->acquire(index));
+
+  for (size_t i=1 ; i < timeStepWindow ; i++)
+    if (timeSteps[(index + i) % timeSteps.size()].model == NULL)
+      timeStepLoader->prefetch((index + i) % timeSteps.size());
+
+  currentTimeStep = index;
+
+  //! Set current model on the OSPRay renderer, the model itself was committed when built.
+  ospSetObject(renderer, "model", timeSteps[index].model);
   ospCommit(renderer);
   rendererInitialized = true;
 
   //! Update transfer function and isosurface editor data value range with the voxel range of the current volume.
-  osp::vec2f voxelRange(0.f);  ospGetVec2f(volumes[index], "voxelRange", &voxelRange);
+  osp::vec2f voxelRange(0.f);
+  if (!timeSteps[index].volumes.empty()) ospGetVec2f(timeSteps[index].volumes[0], "voxelRange", &voxelRange);
 
   if(voxelRange != osp::vec2f(0.f)) {
     transferFunctionEditor->setDataValueRange(voxelRange);
@@ -131,12 +168,14 @@ void VolumeViewer::addGeometry(std::string filename)
   //! Load the geometry.
   PLYGeometryFile geometryFile(filename);
 
-  //! Add the OSPRay triangle mesh to all models.
+  //! Add the OSPRay triangle mesh to all resident models, the others get it when they become resident.
   OSPTriangleMesh triangleMesh = geometryFile.getOSPTriangleMesh();
+  geometries.push_back(triangleMesh);
 
-  for(unsigned int i=0; i<models.size(); i++) {
-    ospAddGeometry(models[i], triangleMesh);
-    ospCommit(models[i]);
+  for(unsigned int i=0; i<timeSteps.size(); i++) {
+    if (timeSteps[i].model == NULL) continue;
+    ospAddGeometry(timeSteps[i].model, triangleMesh);
+    ospCommit(timeSteps[i].model);
   }
 
   //! Force render.
@@ -165,36 +204,62 @@ void VolumeViewer::screenshot(std::string filename)
   std::cout << (success ? "saved screenshot to " : "failed saving screenshot ") << filename << std::endl;
 }
 
-void VolumeViewer::importObjectsFromFile(const std::string &filename)
+void VolumeViewer::commitVolumes()
+{
+  for (size_t i=0 ; i < timeSteps.size() ; i++)
+    for (size_t j=0 ; j < timeSteps[i].volumes.size() ; j++)
+      commitVolume(timeSteps[i].volumes[j]);
+}
+
+void VolumeViewer::commitVolume(OSPVolume volume)
 {
-  //! Create an OSPRay model.
-  OSPModel model = ospNewModel();
+  if (gradientShadingEnabled >= 0)
+    ospSet1i(volume, "gradientShadingEnabled", gradientShadingEnabled);
 
-  //! Load OSPRay objects from a file.
-  OSPObject *objects = ObjectFile::importObjects(filename.c_str());
+  if (precomputedGradientsEnabled >= 0)
+    ospSet1i(volume, "precomputedGradients", precomputedGradientsEnabled);
 
-  //! Iterate over the volumes contained in the object list.
-  for (size_t i=0 ; objects[i] ; i++) {
-    OSPDataType type;
-    ospGetType(objects[i], NULL, &type);
+  if (samplingRate >= 0.f)
+    ospSet1f(volume, "samplingRate", samplingRate);
 
-    if (type == OSP_VOLUME) {
+  if (volumeClippingBoxSet) {
+    ospSet3fv(volume, "volumeClippingBoxLower", &volumeClippingBox.lower.x);
+    ospSet3fv(volume, "volumeClippingBoxUpper", &volumeClippingBox.upper.x);
+  }
 
-      //! For now we set the same transfer function on all volumes.
-      ospSetObject(objects[i], "transferFunction", transferFunction);
-      ospCommit(objects[i]);
+  if (isovaluesData != NULL)
+    ospSetData(volume, "isovalues", isovaluesData);
 
-      //! Add the loaded volume(s) to the model.
-      ospAddVolume(model, (OSPVolume) objects[i]);
+  ospCommit(volume);
+}
 
-      //! Keep a vector of all loaded volume(s).
-      volumes.push_back((OSPVolume) objects[i]);
-    }
+void VolumeViewer::buildTimeSteps()
+{
+  //! Timer events are handled between frames, so the OSPRay objects are not in use. One time step per event keeps the interface responsive.
+  for (size_t i=1 ; i < timeStepWindow ; i++) {
+    const size_t index = (currentTimeStep + i) % timeSteps.size();
+    if (timeSteps[index].model != NULL || !timeStepLoader->isStaged(index)) continue;
+    adoptTimeStep(index, timeStepLoader->acquire(index));
+    return;
   }
+}
 
-  //! Commit the model.
-  ospCommit(model);
-  models.push_back(model);
+void VolumeViewer::adoptTimeStep(size_t index, const TimeStep &timeStep)
+{
+  timeSteps[index] = timeStep;
+  if (timeStep.model == NULL)
+    return;
+
+  //! Parameters changed while the time step was not resident.
+  for (size_t i=0 ; i < timeStep.volumes.size() ; i++)
+    commitVolume(timeStep.volumes[i]);
+
+  //! Geometry shared by all time steps.
+  if (!geometries.empty()) {
+    for (size_t i=0 ; i < geometries.size() ; i++)
+      ospAddGeometry(timeStep.model, geometries[i]);
+    ospCommit(timeStep.model);
+  }
 }
 
 void VolumeViewer::initObjects()
@@ -226,14 +291,15 @@ void VolumeViewer::initObjects()
   //! Set the dynamic model on the renderer.
   ospSetObject(renderer, "dynamic_model", dynamicModel);
 
-  //! Load OSPRay objects from files.
-  for (size_t i=0 ; i < objectFileFilenames.size() ; i++)
-    importObjectsFromFile(objectFileFilenames[i]);
+  //! Load time steps from the OSPRay object files, the first one right away.
+  timeStepLoader = new TimeStepLoader(objectFileFilenames, transferFunction);
+  if (!timeSteps.empty())
+    adoptTimeStep(0, timeStepLoader->acquire(0));
 
   //! Get the bounding box of the first volume.
-  if(volumes.size() > 0) {
-    ospGetVec3f(volumes[0], "boundingBoxMin", &boundingBox.lower);
-    ospGetVec3f(volumes[0], "boundingBoxMax", &boundingBox.upper);
+  if(!timeSteps.empty() && timeSteps[0].volumes.size() > 0) {
+    ospGetVec3f(timeSteps[0].volumes[0], "boundingBoxMin", &boundingBox.lower);
+    ospGetVec3f(timeSteps[0].volumes[0], "boundingBoxMax", &boundingBox.upper);
   }
 }
 
@@ -268,6 +334,10 @@ void VolumeViewer::initUserInterfaceWidgets()
   //! Connect the "play timesteps" timer.
   connect(&playTimeStepsTimer, SIGNAL(timeout()), this, SLOT(nextTimeStep()));
 
+  //! Build prefetched time steps as soon as their files have been read, so switching to them only sets the model.
+  connect(&buildTimeStepsTimer, SIGNAL(timeout()), this, SLOT(buildTimeSteps()));
+  if (timeStepWindow > 1) buildTimeStepsTimer.start(50);
+
   //! Add the "add geometry" widget and callback.
   QAction *addGeometryAction = new QAction("Add geometry", this);
   connect(addGeometryAction, SIGNAL(triggered()), this, SLOT(addGeometry()));
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "QOSPRayWindow.h"
+#include "TimeStepLoader.h"
 #include <QtGui>
 #include <string>
 #include <vector>
@@ -31,10 +32,10 @@ Q_OBJECT
 public:
 
   //! Constructor.
-  VolumeViewer(const std::vector<std::string> &objectFileFilenames, bool showFrameRate, std::string writeFramesFilename);
+  VolumeViewer(const std::vector<std::string> &objectFileFilenames, bool showFrameRate, std::string writeFramesFilename, size_t timeStepWindow);
 
   //! Destructor.
-  ~VolumeViewer() {};
+  ~VolumeViewer();
 
   //! Get the OSPRay output window.
   QOSPRayWindow *getWindow() { return(osprayWindow); }
@@ -42,7 +43,7 @@ public:
   //! Get the transfer function editor.
   TransferFunctionEditor *getTransferFunctionEditor() { return(transferFunctionEditor); }
 
-  //! Select the model (time step) to be displayed.
+  //! Select the model (time step) to be displayed, making it and the following time steps in the window resident.
   void setModel(size_t index);
 
   //! A string description of this class.
@@ -57,11 +58,14 @@ public slots:
   void setAutoRotationRate(float rate) { autoRotationRate = rate; }
 
   //! Draw the model associated with the next time step.
-  void nextTimeStep() { static size_t index = 0;  index = (index + 1) % models.size();  setModel(index);  render(); }
+  void nextTimeStep() { if (timeSteps.empty()) return;  setModel((currentTimeStep + 1) % timeSteps.size());  render(); }
 
   //! Toggle animation over the time steps.
   void playTimeSteps(bool animate) { if (animate == true) playTimeStepsTimer.start(500);  else playTimeStepsTimer.stop(); }
 
+  //! Create and commit the next time step in the window whose files have been read, between frames.
+  void buildTimeSteps();
+
   //! Add a slice to the volume, optionally from file.
   void addSlice(std::string filename = std::string());
 
@@ -71,8 +75,8 @@ public slots:
   //! Save screenshot.
   void screenshot(std::string filename = std::string());
 
-  //! Re-commit all OSPRay volumes.
-  void commitVolumes() { for(size_t i=0; i<volumes.size(); i++) ospCommit(volumes[i]); }
+  //! Re-commit all resident OSPRay volumes.
+  void commitVolumes();
 
   //! Force the OSPRay window to be redrawn.
   void render() { if (osprayWindow != NULL) { osprayWindow->resetAccumulationBuffer(); osprayWindow->updateGL(); } }
@@ -84,31 +88,22 @@ public slots:
   }
 
   //! Set gradient shading flag on all volumes.
-  void setGradientShadingEnabled(bool value) {
-    for(size_t i=0; i<volumes.size(); i++) { ospSet1i(volumes[i], "gradientShadingEnabled", value); ospCommit(volumes[i]); }
-    render();
-  }
+  void setGradientShadingEnabled(bool value) { gradientShadingEnabled = value;  commitVolumes();  render(); }
+
+  //! Set precomputed gradients flag on all volumes.
+  void setPrecomputedGradientsEnabled(bool value) { precomputedGradientsEnabled = value;  commitVolumes();  render(); }
 
   //! Set sampling rate on all volumes.
-  void setSamplingRate(double value) {
-    for(size_t i=0; i<volumes.size(); i++) { ospSet1f(volumes[i], "samplingRate", value); ospCommit(volumes[i]); }
-    render();
-  }
+  void setSamplingRate(double value) { samplingRate = value;  commitVolumes();  render(); }
 
   //! Set volume clipping box on all volumes.
-  void setVolumeClippingBox(osp::box3f value) {
-    for(size_t i=0; i<volumes.size(); i++) {
-      ospSet3fv(volumes[i], "volumeClippingBoxLower", &value.lower.x);
-      ospSet3fv(volumes[i], "volumeClippingBoxUpper", &value.upper.x);
-      ospCommit(volumes[i]);
-    }
-    render();
-  }
+  void setVolumeClippingBox(osp::box3f value) { volumeClippingBox = value;  volumeClippingBoxSet = true;  commitVolumes();  render(); }
 
   //! Set isosurface on all volumes; for now only one isovalue supported.
   void setIsovalues(std::vector<float> isovalues) {
-    OSPData isovaluesData = ospNewData(isovalues.size(), OSP_FLOAT, &isovalues[0]);
-    for(size_t i=0; i<volumes.size(); i++) { ospSetData(volumes[i], "isovalues", isovaluesData); ospCommit(volumes[i]); }
+    if (isovaluesData != NULL) ospRelease(isovaluesData);
+    isovaluesData = ospNewData(isovalues.size(), OSP_FLOAT, &isovalues[0]);
+    commitVolumes();
     render();
   }
 
@@ -117,16 +112,34 @@ protected:
   //! OSPRay object file filenames, one for each model / time step.
   std::vector<std::string> objectFileFilenames;
 
-  //! OSPRay models.
-  std::vector<OSPModel> models;
+  //! OSPRay models and volumes per time step, only the time steps in the window are resident.
+  std::vector<TimeStep> timeSteps;
+
+  //! Number of time steps kept resident, starting with the displayed one.
+  size_t timeStepWindow;
+
+  //! Index of the displayed time step.
+  size_t currentTimeStep;
+
+  //! Loads upcoming time steps in the background.
+  TimeStepLoader *timeStepLoader;
+
+  //! Geometry added to the models of all time steps.
+  std::vector<OSPGeometry> geometries;
 
   //! Model for dynamic geometry (slices); maintained separately from other geometry.
   OSPModel dynamicModel;
 
-  //! OSPRay volumes.
-  std::vector<OSPVolume> volumes;
+  //! Volume parameters set interactively, applied to the volumes of each time step as it becomes resident (a negative value is unset).
+  int gradientShadingEnabled;  int precomputedGradientsEnabled;  float samplingRate;
 
-  //! Bounding box of the (first) volume.
+  //! Volume clipping box, applied to the volumes of each time step if set.
+  osp::box3f volumeClippingBox;  bool volumeClippingBoxSet;
+
+  //! Isovalues, applied to the volumes of each time step if not NULL.
+  OSPData isovaluesData;
+
+  //! Bounding box of the first volume, the time steps are assumed to share its grid.
   osp::box3f boundingBox;
 
   //! OSPRay renderer.
@@ -162,6 +175,9 @@ protected:
   //! Timer for use when stepping through multiple models.
   QTimer playTimeStepsTimer;
 
+  //! Timer polling for time steps to build ahead of their display.
+  QTimer buildTimeStepsTimer;
+
   //! Label for current OSPRay object file information.
   QLabel currentFilenameInfoLabel;
 
@@ -173,8 +189,11 @@ protected:
   void exitOnCondition(bool condition, const std::string &message) const
   { if (!condition) return;  emitMessage("ERROR", message);  exit(1); }
 
-  //! Load an OSPRay model from a file.
-  void importObjectsFromFile(const std::string &filename);
+  //! Apply the interactively set volume parameters to a volume and commit it.
+  void commitVolume(OSPVolume volume);
+
+  //! Take ownership of a loaded time step, adding the shared geometry and volume parameters.
+  void adoptTimeStep(size_t index, const TimeStep &timeStep);
 
   //! Create and configure the OSPRay state.
   void initObjects();
@@ -14,6 +14,7 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+#include <algorithm>
 #include <iostream>
 #include <QtGui>
 #include <ctype.h>
@@ -45,6 +46,7 @@ int main(int argc, char *argv[]) {
     std::cerr << "    -rotate <rate>                       : automatically rotate view according to 'rate'" << std::endl;
     std::cerr << "    -showframerate                       : show the frame rate in the window title bar"   << std::endl;
     std::cerr << "    -slice <filename>                    : load volume slice from 'filename'"             << std::endl;
+    std::cerr << "    -timestepwindow <n>                  : keep 'n' time steps resident (default 2)"      << std::endl;
     std::cerr << "    -transferfunction <filename>         : load transfer function from 'filename'"        << std::endl;
     std::cerr << "    -viewsize <width>x<height>           : force OSPRay view size to 'width'x'height'"    << std::endl;
     std::cerr << "    -viewup <x> <y> <z>                  : set viewport up vector to ('x', 'y', 'z')"     << std::endl;
@@ -73,6 +75,7 @@ int main(int argc, char *argv[]) {
   osp::vec3f viewUp(0.f);
   bool showFrameRate = false;
   std::string writeFramesFilename;
+  int timeStepWindow = 2;
 
   //! Parse the optional command line arguments.
   for (int i=objectFileFilenames.size() + 1 ; i < argc ; i++) {
@@ -109,6 +112,12 @@ int main(int argc, char *argv[]) {
       showFrameRate = true;
       std::cout << "set show frame rate" << std::endl;
 
+    } else if (arg == "-timestepwindow") {
+
+      if (i + 1 >= argc) throw std::runtime_error("missing <n> argument");
+      timeStepWindow = atoi(argv[++i]);
+      std::cout << "got timeStepWindow = " << timeStepWindow << std::endl;
+
     } else if (arg == "-transferfunction") {
 
       if (i + 1 >= argc) throw std::runtime_error("missing <filename> argument");
@@ -171,7 +180,7 @@ int main(int argc, char *argv[]) {
   }
 
   //! Create the OSPRay state and viewer window.
-  VolumeViewer *volumeViewer = new VolumeViewer(objectFileFilenames, showFrameRate, writeFramesFilename);
+  VolumeViewer *volumeViewer = new VolumeViewer(objectFileFilenames, showFrameRate, writeFramesFilename, std::max(timeStepWindow, 0));
 
   //! Display the first model.
   volumeViewer->setModel(0);
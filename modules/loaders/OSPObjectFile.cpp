@@ -171,8 +171,8 @@ OSPObject *OSPObjectFile::importObjects() {
 
 OSPVolume OSPObjectFile::importVolume(const tinyxml2::XMLNode *root) {
 
-  //! Create the OSPRay object.
-  OSPVolume volume = ospNewVolume("block_bricked_volume");
+  //! Create the OSPRay object, volumes with a compression mode are stored in compressed bricks.
+  OSPVolume volume = ospNewVolume(root->FirstChildElement("compression") ? "compressed_bricked_volume" : "block_bricked_volume");
 
   //! Temporary storage for the file name attribute if specified.
   const char *volumeFilename = NULL;
@@ -180,12 +180,18 @@ OSPVolume OSPObjectFile::importVolume(const tinyxml2::XMLNode *root) {
   //! Iterate over object attributes.
   for (const tinyxml2::XMLNode *node = root->FirstChild() ; node ; node = node->NextSibling()) {
 
+    //! Brick compression mode ("lossless" or "lossy").
+    if (!strcmp(node->ToElement()->Name(), "compression")) { importAttributeString(node, volume);  continue; }
+
     //! Volume size in voxels per dimension.
     if (!strcmp(node->ToElement()->Name(), "dimensions")) { importAttributeInteger3(node, volume);  continue; }
 
     //! File containing a volume specification and / or voxel data.
     if (!strcmp(node->ToElement()->Name(), "filename")) { volumeFilename = node->ToElement()->GetText();  continue; }
 
+    //! Store a one voxel halo per brick to speed up sampling.
+    if (!strcmp(node->ToElement()->Name(), "ghostVoxels")) { importAttributeInteger(node, volume);  continue; }
+
     //! Gamma correction coefficient and exponent.
     if (!strcmp(node->ToElement()->Name(), "gammaCorrection")) { importAttributeFloat2(node, volume);  continue; }
 
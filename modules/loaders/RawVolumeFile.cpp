@@ -33,10 +33,10 @@ OSPVolume RawVolumeFile::importVolume(OSPVolume volume) {
   char *voxelType;  exitOnCondition(!ospGetString(volume, "voxelType", &voxelType), "no voxel type specified");
 
   //! Supported voxel types.
-  exitOnCondition(strcmp(voxelType, "float") && strcmp(voxelType, "uchar"), "unsupported voxel type");
+  exitOnCondition(strcmp(voxelType, "float") && strcmp(voxelType, "uchar") && strcmp(voxelType, "ushort") && strcmp(voxelType, "short") && strcmp(voxelType, "half"), "unsupported voxel type");
 
   //! Voxel size in bytes.
-  size_t voxelSize = strcmp(voxelType, "float") ? sizeof(unsigned char) : sizeof(float);
+  size_t voxelSize = !strcmp(voxelType, "float") ? sizeof(float) : !strcmp(voxelType, "uchar") ? sizeof(unsigned char) : sizeof(unsigned short);
 
   //! Check if a subvolume of the volume has been specified.
   //! Subvolume parameters: subvolumeOffsets, subvolumeDimensions, subvolumeSteps.
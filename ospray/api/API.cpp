@@ -231,6 +231,15 @@ namespace ospray {
     return ospray::api::Device::current->newData(nitems,format,(void*)init,flags);
   }
 
+  extern "C" OSPData ospNewSharedData(size_t nitems, OSPDataType format, void *data,
+                                      OSPDataReleaseFunc releaseFunc, void *userPtr,
+                                      int flags)
+  {
+    ASSERT_DEVICE();
+    return ospray::api::Device::current->newSharedData(nitems,format,data,
+                                                       releaseFunc,userPtr,flags);
+  }
+
   /*! add a data array to another object */
   extern "C" void ospSetData(OSPObject object, const char *bufName, OSPData data)
   { 
@@ -413,6 +422,17 @@ namespace ospray {
 #endif
   }
 
+  extern "C" void ospRenderFrames(int numFrames,
+                                  const OSPFrameBuffer *fb,
+                                  const OSPRenderer *renderer,
+                                  const OSPCamera *camera,
+                                  const uint32 fbChannelFlags=OSP_FB_COLOR)
+  {
+    ASSERT_DEVICE();
+    Assert2(numFrames == 0 || (fb && renderer),"invalid frame batch");
+    ospray::api::Device::current->renderFrames(numFrames,fb,renderer,camera,fbChannelFlags);
+  }
+
   extern "C" void ospCommit(OSPObject object)
   {
     // assert(!rendering);
@@ -621,6 +641,18 @@ namespace ospray {
     *result = ospray::api::Device::current->pick(renderer, screenPos);
   }
 
+  extern "C" void ospPickBatch(OSPRenderer renderer, size_t numPositions,
+                               const vec2f *screenPos, OSPPickResult *results,
+                               OSPPickHitInfo *hitInfo)
+  {
+    ASSERT_DEVICE();
+    Assert2(renderer, "NULL renderer passed to ospPickBatch");
+    if (numPositions == 0) return;
+    Assert2(screenPos && results, "NULL array passed to ospPickBatch");
+    ospray::api::Device::current->pickBatch(renderer, numPositions, screenPos,
+                                            results, hitInfo);
+  }
+
   extern "C" OSPPickData ospUnproject(OSPRenderer renderer, const vec2f &screenPos)
   {
     static bool warned = false;
@@ -20,6 +20,7 @@
 #include "Device.h"
 #include "COIDeviceCommon.h"
 #include "ospray/common/Data.h"
+#include "ospray/texture/Texture2D.h"
 // coi
 #include "common/COIResult_common.h"
 #include "source/COIEngine_source.h"
@@ -786,7 +787,7 @@ namespace ospray {
       args.write((int32)height);
       args.write((int32)type);
       args.write((int32)flags);
-      int64 numBytes = sizeOf(type)*width*height;
+      int64 numBytes = Texture2D::numBytes(width,height,type);
       // double t0 = getSysTime();
       for (int i=0;i<engine.size();i++) {
         COIBUFFER coiBuffer;
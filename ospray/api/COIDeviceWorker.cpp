@@ -299,10 +299,11 @@ namespace ospray {
         = (FrameBuffer::ColorBufferFormat)mode;
       bool hasDepthBuffer = (channels & OSP_FB_DEPTH)!=0;
       bool hasAccumBuffer = (channels & OSP_FB_ACCUM)!=0;
+      bool hasHistoryBuffer = (channels & OSP_FB_HISTORY)!=0;
       
       FrameBuffer *fb = new LocalFrameBuffer(size,colorBufferFormat,
                                              hasDepthBuffer,hasAccumBuffer,
-                                             pixelArray);
+                                             pixelArray,hasHistoryBuffer);
       handle.assign(fb);
 
       if (ospray::debugMode) COIProcessProxyFlush();
@@ -32,5 +32,16 @@ namespace ospray {
       rtcSetErrorFunction(error_handler);
     }
 
+    OSPData Device::newSharedData(size_t nitems, OSPDataType format, void *data,
+                                  OSPDataReleaseFunc releaseFunc, void *userPtr,
+                                  int flags)
+    {
+      OSPData handle = newData(nitems,format,data,
+                               flags & ~(OSP_DATA_SHARED_BUFFER|OSP_DATA_PADDED_BUFFER));
+      if (releaseFunc)
+        releaseFunc(data,userPtr);
+      return handle;
+    }
+
   } // ::ospray::api
 } // ::ospray
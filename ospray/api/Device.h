@@ -70,6 +70,15 @@ namespace ospray {
       /*! create a new data buffer */
       virtual OSPData newData(size_t nitems, OSPDataType format, void *init, int flags) = 0;
 
+      /*! create a new data buffer that takes over ownership of 'data'
+          and calls 'releaseFunc' once it is no longer needed. The
+          default implementation is for devices that copy the data
+          anyway: it creates a regular data buffer and releases 'data'
+          right away. */
+      virtual OSPData newSharedData(size_t nitems, OSPDataType format, void *data,
+                                    OSPDataReleaseFunc releaseFunc, void *userPtr,
+                                    int flags);
+
       /*! Copy data into the given volume. */
       virtual int setRegion(OSPVolume object, const void *source, 
                             const vec3i &index, const vec3i &count) = 0;
@@ -180,6 +189,15 @@ namespace ospray {
                                OSPRenderer _renderer, 
                                const uint32 fbChannelFlags) = 0;
 
+      /*! render a batch of frames, frame 'i' rendering 'renderer[i]'
+          into 'fb[i]' with camera 'camera[i]' (if given) */
+      virtual void renderFrames(int numFrames,
+                                const OSPFrameBuffer *fb,
+                                const OSPRenderer *renderer,
+                                const OSPCamera *camera,
+                                const uint32 fbChannelFlags)
+      { throw std::runtime_error("renderFrames() not implemented for this device"); };
+
 
   
       //! release (i.e., reduce refcount of) given object
@@ -208,6 +226,12 @@ namespace ospray {
 
       virtual OSPPickResult pick(OSPRenderer renderer, const vec2f &screenPos) 
       { throw std::runtime_error("pick() not impelemnted for this device"); };
+
+      /*! pick many screen positions at once; 'hitInfo' may be NULL */
+      virtual void pickBatch(OSPRenderer renderer, size_t numPositions,
+                             const vec2f *screenPos, OSPPickResult *results,
+                             OSPPickHitInfo *hitInfo)
+      { throw std::runtime_error("pickBatch() not implemented for this device"); };
     };
   } // ::ospray::api
 } // ::ospray
@@ -25,6 +25,8 @@
 #include "ospray/render/LoadBalancer.h"
 #include "ospray/common/Material.h"
 #include "ospray/common/Library.h"
+#include "ospray/common/NUMA.h"
+#include "ospray/common/Memory.h"
 #include "ospray/texture/Texture2D.h"
 #include "ospray/lights/Light.h"
 
@@ -56,6 +58,11 @@ namespace ospray {
 
       rtcSetErrorFunction(embreeErrorFunc);
 
+      // spread the worker threads evenly across all sockets, rather
+      // than filling up the first socket's cores first
+      if (numaAware)
+        embree::TaskScheduler::setThreadAffinities(numa::interleavedCPUs());
+
       std::stringstream embreeConfig;
       if (debugMode)
         embreeConfig << " threads=1,verbose=2";
@@ -81,9 +88,11 @@ namespace ospray {
       FrameBuffer::ColorBufferFormat colorBufferFormat = mode; //FrameBuffer::RGBA_UINT8;//FLOAT32;
       bool hasDepthBuffer = (channels & OSP_FB_DEPTH)!=0;
       bool hasAccumBuffer = (channels & OSP_FB_ACCUM)!=0;
+      bool hasHistoryBuffer = (channels & OSP_FB_HISTORY)!=0;
       
       FrameBuffer *fb = new LocalFrameBuffer(size,colorBufferFormat,
-                                             hasDepthBuffer,hasAccumBuffer);
+                                             hasDepthBuffer,hasAccumBuffer,
+                                             NULL,hasHistoryBuffer);
       fb->refInc();
       return (OSPFrameBuffer)fb;
     }
@@ -213,6 +222,16 @@ namespace ospray {
       data->refInc();
       return (OSPData)data;
     }
+
+    OSPData LocalDevice::newSharedData(size_t nitems, OSPDataType format, void *init,
+                                       OSPDataReleaseFunc releaseFunc, void *userPtr,
+                                       int flags)
+    {
+      Data *data = new Data(nitems,format,init,flags|OSP_DATA_SHARED_BUFFER,
+                            releaseFunc,userPtr);
+      data->refInc();
+      return (OSPData)data;
+    }
     
     /*! assign (named) string parameter to an object */
     void LocalDevice::setString(OSPObject _object, const char *bufName, const char *s)
@@ -571,6 +590,23 @@ namespace ospray {
       return 0;
     }
 
+    /*! print how much of the large buffers allocated so far
+        actually got backed by huge pages; done once, on the first
+        frame, when all of the scene's data has been allocated */
+    static void reportLargeAllocStats()
+    {
+      static bool reported = false;
+      if (reported || logLevel < 1) return;
+      reported = true;
+
+      const LargeAllocStats stats = getLargeAllocStats();
+      const double MB = 1024.*1024.;
+      std::cout << "#osp: large buffers: " << stats.numBytes/MB << "MB, "
+                << stats.explicitHugeBytes/MB << "MB in explicit huge pages, "
+                << stats.transparentHugeBytes/MB << "MB in transparent huge pages"
+                << std::endl;
+    }
+
     /*! call a renderer to render a frame buffer */
     void LocalDevice::renderFrame(OSPFrameBuffer _fb, 
                                   OSPRenderer    _renderer, 
@@ -585,6 +621,7 @@ namespace ospray {
       // Assert(sc != NULL && "invalid frame buffer handle");
       Assert(renderer != NULL && "invalid renderer handle");
       
+      reportLargeAllocStats();
       // FrameBuffer *fb = sc->getBackBuffer();
       renderer->renderFrame(fb,fbChannelFlags);
       // WARNING: I'm doing an *im*plicit swapbuffers here at the end
@@ -593,6 +630,29 @@ namespace ospray {
       // sc->advance();
     }
 
+    /*! render a batch of frames, all in one go */
+    void LocalDevice::renderFrames(int numFrames,
+                                   const OSPFrameBuffer *_fb,
+                                   const OSPRenderer *_renderer,
+                                   const OSPCamera *_camera,
+                                   const uint32 fbChannelFlags)
+    {
+      std::vector<Ref<FrameContext> > frames;
+      for (int i=0;i<numFrames;i++) {
+        FrameBuffer   *fb       = (FrameBuffer *)_fb[i];
+        Renderer      *renderer = (Renderer *)_renderer[i];
+        ManagedObject *camera   = _camera ? (ManagedObject *)_camera[i] : NULL;
+        Assert(fb != NULL && "invalid frame buffer handle");
+        Assert(renderer != NULL && "invalid renderer handle");
+        for (int j=0;j<i;j++)
+          if (frames[j]->fb.ptr == fb)
+            throw std::runtime_error("frame buffer appears more than once in frame batch");
+        frames.push_back(new FrameContext(renderer,fb,fbChannelFlags,camera));
+      }
+      reportLargeAllocStats();
+      TiledLoadBalancer::instance->renderFrames(frames);
+    }
+
     //! release (i.e., reduce refcount of) given object
     /*! Note that all objects in ospray are refcounted, so one cannot
       explicitly "delete" any object. Instead, each object is created
@@ -626,6 +686,16 @@ namespace ospray {
       return renderer->pick(screenPos);
     }
 
+    void LocalDevice::pickBatch(OSPRenderer _renderer, size_t numPositions,
+                                const vec2f *screenPos, OSPPickResult *results,
+                                OSPPickHitInfo *hitInfo)
+    {
+      Assert(_renderer != NULL && "invalid renderer handle");
+      Renderer *renderer = (Renderer*)_renderer;
+
+      renderer->pickBatch(numPositions, screenPos, results, hitInfo);
+    }
+
   } // ::ospray::api
 } // ::ospray
 
@@ -60,6 +60,11 @@ namespace ospray {
       /*! create a new data buffer */
       virtual OSPData newData(size_t nitems, OSPDataType format, void *init, int flags);
 
+      /*! create a new data buffer that takes over ownership of 'data' */
+      virtual OSPData newSharedData(size_t nitems, OSPDataType format, void *data,
+                                    OSPDataReleaseFunc releaseFunc, void *userPtr,
+                                    int flags);
+
       /*! load module */
       virtual int loadModule(const char *name);
 
@@ -173,6 +178,13 @@ namespace ospray {
                                OSPRenderer _renderer, 
                                const uint32 fbChannelFlags);
 
+      /*! render a batch of frames, all in one go */
+      virtual void renderFrames(int numFrames,
+                                const OSPFrameBuffer *fb,
+                                const OSPRenderer *renderer,
+                                const OSPCamera *camera,
+                                const uint32 fbChannelFlags);
+
       //! release (i.e., reduce refcount of) given object
       /*! note that all objects in ospray are refcounted, so one cannot
         explicitly "delete" any object. instead, each object is created
@@ -189,6 +201,11 @@ namespace ospray {
       virtual void setMaterial(OSPGeometry _geom, OSPMaterial _mat);
 
       virtual OSPPickResult pick(OSPRenderer renderer, const vec2f &screenPos);
+
+      /*! pick many screen positions at once */
+      virtual void pickBatch(OSPRenderer renderer, size_t numPositions,
+                             const vec2f *screenPos, OSPPickResult *results,
+                             OSPPickHitInfo *hitInfo);
     };
 
   } // ::ospray::api
@@ -39,6 +39,15 @@ namespace ospray {
     fovy   = getParamf("fovy",60.f);
     aspect = getParamf("aspect",1.f);
     nearClip = getParam1f("near_clip",getParam1f("nearClip",1e-6f));
+    apertureRadius = getParamf("apertureRadius",0.f);
+    focusDistance  = getParamf("focusDistance",1.f);
+    shutterOpen    = getParamf("shutterOpen",0.f);
+    shutterClose   = getParamf("shutterClose",shutterOpen);
+
+    if (apertureRadius < 0.f)
+      throw std::runtime_error("perspective camera: apertureRadius must not be negative");
+    if (apertureRadius > 0.f && focusDistance <= 0.f)
+      throw std::runtime_error("perspective camera: focusDistance must be positive");
 
 
     // ------------------------------------------------------------------
@@ -62,7 +71,11 @@ namespace ospray {
                                 (const ispc::vec3f&)dir_00,
                                 (const ispc::vec3f&)dir_du,
                                 (const ispc::vec3f&)dir_dv,
-                                nearClip);
+                                nearClip,
+                                apertureRadius,
+                                focusDistance,
+                                shutterOpen,
+                                shutterClose);
   }
 
   void PerspectiveCamera::initRay(Ray &ray, const vec2f &sample)
@@ -81,7 +94,7 @@ namespace ospray {
 
     ray.t0  = 1e-6f;
     ray.t   = std::numeric_limits<float>::infinity();
-    ray.time = 0.f;
+    ray.time = shutterOpen;
     ray.mask = -1;
     ray.geomID = -1;
     ray.primID = -1;
@@ -27,7 +27,8 @@ namespace ospray {
   /*! \defgroup perspective_camera The Perspective Camera ("perspective")
 
     \brief Implements a straightforward perspective (or "pinhole"
-    camera) for perspective rendering, without support for Depth of Field or Motion Blur
+    camera) for perspective rendering, with optional Depth of Field
+    (thin lens) and Motion Blur (shutter interval)
 
     \ingroup ospray_supported_cameras
     
@@ -43,8 +44,17 @@ namespace ospray {
     float    far;    // camera far plane (not all renderers may support this!)
     float    fovy;   // field of view (camera opening angle) in frame's y dimension
     float    aspect; // aspect ratio (x/y)
+    float    apertureRadius; // radius of the lens, 0 (default) for a pinhole camera
+    float    focusDistance;  // distance of the plane in focus, along 'dir' (default 1)
+    float    shutterOpen;    // time the shutter opens, in [0..1] between the two
+                             // time steps of moving geometry (default 0)
+    float    shutterClose;   // time the shutter closes (default shutterOpen)
     </pre>
 
+    With a non-zero aperture, and with a shutter interval, renderers
+    need to accumulate several frames (or take several samples per
+    pixel) for the blur to converge.
+
     The functionality for a perspective camera is implemented via the
     \ref ospray::PerspectiveCamera class.
   */
@@ -70,6 +80,10 @@ namespace ospray {
     float  fovy;
     float  aspect;
     float  nearClip;
+    float  apertureRadius;
+    float  focusDistance;
+    float  shutterOpen;
+    float  shutterClose;
 
     // ------------------------------------------------------------------
     // the internal data we preprocessed from our input parameters
@@ -16,24 +16,32 @@
 
 // ospray
 #include "Data.h"
+#include "Memory.h"
 // stl
 #include <sstream>
 
 namespace ospray {
 
-  Data::Data(size_t numItems, OSPDataType type, void *init, int flags)
-    : numItems(numItems), numBytes(numItems * sizeOf(type)), type(type), flags(flags)
+  const size_t Data::padding;
+
+  Data::Data(size_t numItems, OSPDataType type, void *init, int flags,
+             OSPDataReleaseFunc releaseFunc, void *releasePtr)
+    : numItems(numItems), numBytes(numItems * sizeOf(type)), type(type), flags(flags),
+      releaseFunc(releaseFunc), releasePtr(releasePtr)
   {
     /* two notes here:
-       a) i'm using embree's 'new' to enforce alignment
-       b) i'm adding 16 bytes to size to enforce 4-float padding (which embree
-          requires in some buffers 
+       a) i'm using allocLarge() to enforce alignment (and to get
+          huge pages for large arrays)
+       b) i'm adding 'padding' bytes to size to enforce 4-float
+          padding (which embree requires in some buffers); shared
+          buffers are never copied, see isPadded()
     */
     if (flags & OSP_DATA_SHARED_BUFFER) {
       Assert2(init != NULL, "shared buffer is NULL");
       data = init;
     } else {
-      data = new unsigned char[numBytes+16]; 
+      Assert2(releaseFunc == NULL, "release callback given for a non-shared buffer");
+      data = allocLarge(numBytes+padding);
       if (init)
         memcpy(data,init,numBytes);
       else if (type == OSP_OBJECT)
@@ -54,7 +62,10 @@ namespace ospray {
       for (int i=0;i<numItems;i++)
         if (child[i]) child[i]->refDec();
     }
-    if (!(flags & OSP_DATA_SHARED_BUFFER)) free(data);
+    if (!(flags & OSP_DATA_SHARED_BUFFER))
+      freeLarge(data);
+    else if (releaseFunc)
+      releaseFunc(data,releasePtr);
   }
 
 } // ::ospray
@@ -22,22 +22,49 @@
 namespace ospray {
 
   /*! \brief defines a data array (aka "buffer") type that contains
-      'n' items of a given type */
+      'n' items of a given type
+
+    Buffers created with OSP_DATA_SHARED_BUFFER reference the app's
+    memory directly; all other buffers are copied into 64-byte
+    aligned memory that is padded by 'padding' bytes, which embree
+    requires for some buffers (it reads vertices with 16-byte loads).
+    Shared buffers are only known to be padded if the app passed
+    OSP_DATA_PADDED_BUFFER; consumers that need padding check
+    isPadded() and make a padded copy only if required.
+
+    If a 'releaseFunc' is given, it gets called with the shared
+    buffer once the data array gets destroyed, i.e., once its
+    refcount drops to zero.
+  */
   struct Data : public ManagedObject
   {
     virtual std::string toString() const { return "ospray::Data"; }
 
-    Data(size_t numItems, OSPDataType type, void *data, int flags);
+    Data(size_t numItems, OSPDataType type, void *data, int flags,
+         OSPDataReleaseFunc releaseFunc=NULL, void *releasePtr=NULL);
     virtual ~Data();
 
     /*! return number of items in this data buffer */
     inline size_t size() const { return numItems; }
 
+    /*! returns whether at least 'padding' bytes past the end of the
+        buffer are readable */
+    inline bool isPadded() const
+    {
+      return !(flags & OSP_DATA_SHARED_BUFFER) || (flags & OSP_DATA_PADDED_BUFFER);
+    }
+
+    /*! number of readable bytes past the end of padded buffers */
+    static const size_t padding = 16;
+
     void       *data;     /*!< pointer to data */
     size_t      numItems; /*!< number of items */
     size_t      numBytes; /*!< total num bytes (sizeof(type)*numItems) */
     int         flags;    /*!< creation flags */
     OSPDataType type;     /*!< element type */
+
+    OSPDataReleaseFunc releaseFunc; /*!< called on shared buffers upon destruction, may be NULL */
+    void              *releasePtr;  /*!< user pointer passed to 'releaseFunc' */
   };
 
 } // ::ospray
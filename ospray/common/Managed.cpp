@@ -17,9 +17,127 @@
 #include "Managed.h"
 #include "Data.h"
 #include "OSPCommon_ispc.h"
+// embree
+#include "common/sys/sync/mutex.h"
 
 namespace ospray {
 
+  /*! the global table of interned names: open addressing with linear
+      probing, power-of-two size, kept at most half full.
+
+      Lookups are by far the common case, so they do not lock: slots
+      only ever go from empty to filled (hash first, then name), and
+      growing publishes a new, fully filled generation of slots while
+      the old one stays valid (and allocated) for readers still
+      probing it. Only inserting takes the mutex. This relies on
+      stores not being reordered with other stores, nor loads with
+      other loads, as on x86; __memory_barrier() keeps the compiler
+      from reordering them. */
+  struct AtomTable {
+    struct Slots {
+      Slots(size_t size) : size(size), slot(new Atom[size]) {}
+      const size_t size;
+      Atom *const  slot;
+    };
+
+    AtomTable() : numAtoms(0), slots(new Slots(1024)) {}
+
+    static uint32 hashOf(const char *name)
+    {
+      // FNV-1a
+      uint32 hash = 2166136261u;
+      for (const char *c = name; *c; c++)
+        hash = (hash ^ (uint8)*c) * 16777619u;
+      return hash;
+    }
+
+    /*! find the slot 'name' is, or would have to be, stored in; safe
+        to call concurrently with insert() */
+    static size_t find(const Slots *slots, const char *name, uint32 hash)
+    {
+      const size_t mask = slots->size-1;
+      size_t i = hash & mask;
+      while (1) {
+        const char *slotName = ((const char *volatile *)&slots->slot[i].name)[0];
+        __memory_barrier();
+        if (!slotName ||
+            (slots->slot[i].hash == hash && !strcmp(slotName,name)))
+          return i;
+        i = (i+1) & mask;
+      }
+    }
+
+    /*! the atom for 'name', or the invalid atom; does not lock */
+    Atom lookup(const char *name, uint32 hash) const
+    {
+      const Slots *current = ((Slots *const volatile *)&slots)[0];
+      __memory_barrier();
+      const size_t i = find(current,name,hash);
+      Atom atom;
+      atom.name = ((const char *volatile *)&current->slot[i].name)[0];
+      atom.hash = hash;
+      return atom.name ? atom : Atom();
+    }
+
+    /*! the atom for 'name', interning it if required; locks only if
+        'name' has not been interned yet */
+    Atom insert(const char *name, uint32 hash)
+    {
+      Atom atom = lookup(name,hash);
+      if (atom.name) return atom;
+
+      embree::Lock<embree::MutexSys> lock(mutex);
+      size_t i = find(slots,name,hash);
+      if (!slots->slot[i].name) {
+        if (2*(numAtoms+1) > slots->size) {
+          grow();
+          i = find(slots,name,hash);
+        }
+        slots->slot[i].hash = hash;
+        __memory_barrier();
+        ((const char *volatile *)&slots->slot[i].name)[0] = strdup(name);
+        numAtoms++;
+      }
+      return slots->slot[i];
+    }
+
+    /*! publish a generation of twice the size; the old one gets kept
+        since readers may still be using it */
+    void grow()
+    {
+      Slots *grown = new Slots(slots->size*2);
+      for (size_t i=0;i<slots->size;i++)
+        if (slots->slot[i].name)
+          grown->slot[find(grown,slots->slot[i].name,slots->slot[i].hash)] = slots->slot[i];
+      retired.push_back(slots);
+      __memory_barrier();
+      ((Slots *volatile *)&slots)[0] = grown;
+    }
+
+    static AtomTable &get()
+    {
+      static AtomTable table;
+      return table;
+    }
+
+    embree::MutexSys     mutex;    //!< serializes insert()
+    size_t               numAtoms;
+    Slots               *slots;    //!< current generation
+    std::vector<Slots *> retired;  //!< previous generations, never freed
+  };
+
+  Atom::Atom(const char *name)
+  {
+    Assert(name);
+    *this = AtomTable::get().insert(name,AtomTable::hashOf(name));
+  }
+
+  Atom Atom::lookup(const char *name)
+  {
+    Assert(name);
+    return AtomTable::get().lookup(name,AtomTable::hashOf(name));
+  }
+
   /*! \brief constructor */
   ManagedObject::ManagedObject()
     : ID(-1), ispcEquivalent(NULL), managedObjectType(OSP_UNKNOWN) 
@@ -96,41 +214,66 @@ namespace ospray {
     type = OSP_OBJECT;
     ptr = NULL;
   }
-  ManagedObject::Param::Param(const char *name)  
-    : name(NULL), type(OSP_FLOAT), ptr(NULL) 
+  ManagedObject::Param::Param(const Atom &atom)  
+    : name(atom.name), atom(atom), type(OSP_FLOAT), ptr(NULL) 
   {
-    Assert(name);
+    Assert(atom.name);
     f[0] = 0;
     f[1] = 0;
     f[2] = 0;
     f[3] = 0;
-    if (name) this->name = strdup(name);
   };
 
-  void *ManagedObject::getVoidPtr(const char *name, void * valIfNotFound) 
+  ManagedObject::Param *ManagedObject::findParam(const char *name, bool addIfNotExist)
   {
-    Param *param = findParam(name);                                     
-    if (!param) return valIfNotFound;                                   
-    if (param->type != OSP_VOID_PTR) return valIfNotFound;                
-    return (void*)param->ptr;                                            
+    // a name that has never been interned cannot be a parameter of any object
+    const Atom atom = addIfNotExist ? Atom(name) : Atom::lookup(name);
+    if (!atom.name) return NULL;
+    return findParam(atom,addIfNotExist);
   }
 
-  ManagedObject::Param *ManagedObject::findParam(const char *name, bool addIfNotExist)
+  ManagedObject::Param *ManagedObject::findParam(const Atom &atom, bool addIfNotExist)
   {
-    for (size_t i=0 ; i < paramList.size() ; i++) {
-      if (!strcmp(paramList[i]->name,name)) return paramList[i];
+    Assert(atom.name);
+    if (!paramTable.empty()) {
+      const size_t mask = paramTable.size()-1;
+      for (size_t i = atom.hash & mask; paramTable[i]; i = (i+1) & mask)
+        if (paramTable[i]->atom == atom) return paramTable[i];
     }
     if (!addIfNotExist) return NULL;
-    paramList.push_back(new Param(name));
-    return paramList[paramList.size()-1];
+
+    Param *param = new Param(atom);
+    paramList.push_back(param);
+    if (2*paramList.size() > paramTable.size()) {
+      // grow and re-insert everything, including the new parameter
+      paramTable.assign(std::max((size_t)16,2*paramTable.size()),(Param*)NULL);
+      const size_t mask = paramTable.size()-1;
+      for (size_t p=0;p<paramList.size();p++) {
+        size_t i = paramList[p]->atom.hash & mask;
+        while (paramTable[i]) i = (i+1) & mask;
+        paramTable[i] = paramList[p];
+      }
+    } else {
+      const size_t mask = paramTable.size()-1;
+      size_t i = atom.hash & mask;
+      while (paramTable[i]) i = (i+1) & mask;
+      paramTable[i] = param;
+    }
+    return param;
   }
 
-#define define_getparam(T,ABB,TARGETTYPE,FIELD)                       \
-  T ManagedObject::getParam##ABB(const char *name, T valIfNotFound) { \
-  Param *param = findParam(name);                                     \
-  if (!param) return valIfNotFound;                                   \
-  if (param->type != TARGETTYPE) return valIfNotFound;                \
-  return (T&)param->FIELD;                                            \
+#define define_getparam(T,ABB,TARGETTYPE,FIELD)                        \
+  T ManagedObject::getParam##ABB(const char *name, T valIfNotFound) {  \
+  Param *param = findParam(name);                                      \
+  if (!param) return valIfNotFound;                                    \
+  if (param->type != TARGETTYPE) return valIfNotFound;                 \
+  return (T&)param->FIELD;                                             \
+  }                                                                    \
+  T ManagedObject::getParam##ABB(const Atom &name, T valIfNotFound) {  \
+  Param *param = findParam(name);                                      \
+  if (!param) return valIfNotFound;                                    \
+  if (param->type != TARGETTYPE) return valIfNotFound;                 \
+  return (T&)param->FIELD;                                             \
   }
   
   define_getparam(ManagedObject *, Object, OSP_OBJECT, ptr);
@@ -144,6 +287,22 @@ namespace ospray {
   define_getparam(const char *, String, OSP_STRING, ptr);
 
 #undef define_getparam
+
+  void *ManagedObject::getVoidPtr(const char *name, void * valIfNotFound) 
+  {
+    Param *param = findParam(name);                                     
+    if (!param) return valIfNotFound;                                   
+    if (param->type != OSP_VOID_PTR) return valIfNotFound;                
+    return (void*)param->ptr;                                            
+  }
+
+  void *ManagedObject::getVoidPtr(const Atom &name, void * valIfNotFound) 
+  {
+    Param *param = findParam(name);                                     
+    if (!param) return valIfNotFound;                                   
+    if (param->type != OSP_VOID_PTR) return valIfNotFound;                
+    return (void*)param->ptr;                                            
+  }
   
   void ManagedObject::setParam(const char *name, ManagedObject *data)
   {
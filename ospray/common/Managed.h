@@ -28,6 +28,33 @@ namespace ospray {
   /*! forward-def so param can use a pointer to data */
   struct Data;
 
+  /*! \brief an interned parameter name
+
+    All atoms created for equal strings share the same (never freed)
+    name pointer, so comparing two atoms is a single pointer compare,
+    and the name's hash is computed only once, when the atom is
+    created. Objects look up their parameters by atom; the string
+    variants of findParam/getParam* only intern the name first. Code
+    that queries the same parameters over and over (e.g., in 'commit')
+    can create its atoms once, e.g., as function-local statics, and
+    use the atom variants directly.
+  */
+  struct Atom {
+    Atom() : name(NULL), hash(0) {}
+    /*! \brief return the atom for 'name', interning 'name' if required */
+    explicit Atom(const char *name);
+
+    /*! \brief return the atom for 'name' if 'name' has already been
+        interned, and the invalid atom (with NULL name) otherwise */
+    static Atom lookup(const char *name);
+
+    inline bool operator==(const Atom &other) const { return name == other.name; }
+    inline bool operator!=(const Atom &other) const { return name != other.name; }
+
+    const char *name; /*!< interned copy of the name; NULL for the invalid atom */
+    uint32      hash; /*!< hash value of the name */
+  };
+
   /*! \brief defines a basic object whose lifetime is managed by ospray 
 
     One of the core concepts of ospray is that all logical
@@ -130,7 +157,7 @@ namespace ospray {
     /*! \brief container for _any_ sort of parameter an app can assign
         to an ospray object */
     struct Param {
-      Param(const char *name);
+      Param(const Atom &atom);
       ~Param() { clear(); };
 
       /*! clear parameter to 'invalid type and value'; free/de-refcount data if reqd' */
@@ -181,10 +208,14 @@ namespace ospray {
       OSPDataType type;
       /*! name under which this parameter is registered */
       const char *name;
+      /*! interned name under which this parameter is registered */
+      Atom atom;
     };
 
     /*! \brief find a given parameter, or add it if not exists (and so specified) */
     Param *findParam(const char *name, bool addIfNotExist = false);
+    /*! \brief find a given parameter, or add it if not exists (and so specified) */
+    Param *findParam(const Atom &name, bool addIfNotExist = false);
 
     /*! \brief set given parameter to given data array */
     void   setParam(const char *name, ManagedObject *data);
@@ -192,6 +223,9 @@ namespace ospray {
     /*! set a parameter with given name to given value, create param if not existing */
     template<typename T>
     inline void set(const char *name, const T &t) { findParam(name,1)->set(t); }
+    /*! set a parameter with given name to given value, create param if not existing */
+    template<typename T>
+    inline void set(const Atom &name, const T &t) { findParam(name,1)->set(t); }
 
     /*! @{ */
     /*! \brief find the named parameter, and return its object value if
@@ -218,6 +252,25 @@ namespace ospray {
     const char  *getParamString(const char *name, const char *valIfNotFound);
     /*! @} */
 
+    /*! @{ */
+    /*! \brief same as above, but with pre-interned parameter names */
+    ManagedObject *getParamObject(const Atom &name, ManagedObject *valIfNotFound=NULL);
+
+    Data *getParamData(const Atom &name, Data *valIfNotFound=NULL)
+    { return (Data*)getParamObject(name,(ManagedObject*)valIfNotFound); }
+
+    vec3fa getParam3f(const Atom &name, const vec3fa valIfNotFound);
+    vec3f  getParam3f(const Atom &name, const vec3f  valIfNotFound);
+    vec3i  getParam3i(const Atom &name, const vec3i  valIfNotFound);
+    vec2f  getParam2f(const Atom &name, const vec2f  valIfNotFound);
+    int32  getParam1i(const Atom &name, const int32  valIfNotFound);
+    float  getParam1f(const Atom &name, const float  valIfNotFound);
+    float  getParamf (const Atom &name, const float  valIfNotFound);
+
+    void  *getVoidPtr(const Atom &name, void *valIfNotFound);
+    const char  *getParamString(const Atom &name, const char *valIfNotFound);
+    /*! @} */
+
     // ------------------------------------------------------------------
     // functions to allow objects (called a 'listener') to track
     // changes in one or more other objects (called a
@@ -258,9 +311,15 @@ namespace ospray {
        dies */
     std::set<ManagedObject *> objectsListeningForChanges;
     
-    /*! \brief list of parameters attached to this object */
+    /*! \brief list of parameters attached to this object, in the
+        order they got added */
     std::vector<Param *> paramList;
 
+    /*! \brief open-addressing hash table (power-of-two size, linear
+        probing on the atoms' hash values) over 'paramList'; empty
+        slots are NULL */
+    std::vector<Param *> paramTable;
+
     /*! \brief a global ID that can be used for referencing an object remotely */
     id_t ID;
 
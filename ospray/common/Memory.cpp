@@ -0,0 +1,166 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Memory.h"
+// embree
+#include "common/sys/sync/mutex.h"
+// std
+#include <map>
+#include <stdio.h>
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
+
+namespace ospray {
+
+  /*! how a large buffer was allocated */
+  enum LargeAllocKind {
+    LARGE_ALLOC_MALLOC,  /*!< embree::alignedMalloc() */
+    LARGE_ALLOC_PAGES,   /*!< mmap(), transparent huge pages requested */
+    LARGE_ALLOC_HUGETLB  /*!< mmap() of explicitly reserved huge pages */
+  };
+
+  struct LargeAlloc {
+    size_t         numBytes;
+    LargeAllocKind kind;
+  };
+
+  static embree::MutexSys largeAllocMutex;
+  static std::map<void *,LargeAlloc> largeAllocs;
+
+  static void registerLargeAlloc(void *ptr, size_t numBytes, LargeAllocKind kind)
+  {
+    LargeAlloc alloc;
+    alloc.numBytes = numBytes;
+    alloc.kind     = kind;
+    embree::Lock<embree::MutexSys> lock(largeAllocMutex);
+    largeAllocs[ptr] = alloc;
+  }
+
+  void *allocLarge(size_t numBytes)
+  {
+#ifdef __linux__
+    if (numBytes >= HUGE_PAGE_SIZE) {
+      const size_t mapBytes = (numBytes+HUGE_PAGE_SIZE-1)/HUGE_PAGE_SIZE*HUGE_PAGE_SIZE;
+
+# ifdef MAP_HUGETLB
+      /* explicitly reserved huge pages, only if asked for since the
+         pool is shared with other processes; the mapping fails right
+         away if the pool does not have enough free pages left */
+      if (explicitHugePages) {
+        void *huge = mmap(NULL,mapBytes,PROT_READ|PROT_WRITE,
+                          MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+        if (huge != MAP_FAILED) {
+          registerLargeAlloc(huge,mapBytes,LARGE_ALLOC_HUGETLB);
+          return huge;
+        }
+      }
+# endif
+
+      /* regular pages; transparent huge pages can only back ranges
+         that are aligned to the huge page size, so over-allocate and
+         trim the mapping to an aligned range */
+      char *raw = (char*)mmap(NULL,mapBytes+HUGE_PAGE_SIZE,PROT_READ|PROT_WRITE,
+                              MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+      if (raw == MAP_FAILED)
+        throw std::runtime_error("allocLarge: out of memory");
+      char *ptr = (char*)(((size_t)raw+HUGE_PAGE_SIZE-1)&~(HUGE_PAGE_SIZE-1));
+      char *end = raw+mapBytes+HUGE_PAGE_SIZE;
+      if (ptr > raw) munmap(raw,ptr-raw);
+      if (end > ptr+mapBytes) munmap(ptr+mapBytes,end-(ptr+mapBytes));
+# ifdef MADV_HUGEPAGE
+      madvise(ptr,mapBytes,MADV_HUGEPAGE);
+# endif
+      registerLargeAlloc(ptr,mapBytes,LARGE_ALLOC_PAGES);
+      return ptr;
+    }
+#endif
+
+    void *ptr = embree::alignedMalloc(numBytes,64);
+    if (ptr) registerLargeAlloc(ptr,numBytes,LARGE_ALLOC_MALLOC);
+    return ptr;
+  }
+
+  void freeLarge(void *ptr)
+  {
+    if (ptr == NULL) return;
+
+    LargeAlloc alloc;
+    {
+      embree::Lock<embree::MutexSys> lock(largeAllocMutex);
+      std::map<void *,LargeAlloc>::iterator it = largeAllocs.find(ptr);
+      Assert2(it != largeAllocs.end(),"freeLarge() of memory not allocated by allocLarge()");
+      if (it == largeAllocs.end()) return;
+      alloc = it->second;
+      largeAllocs.erase(it);
+    }
+
+#ifdef __linux__
+    if (alloc.kind != LARGE_ALLOC_MALLOC) {
+      munmap(ptr,alloc.numBytes);
+      return;
+    }
+#endif
+    embree::alignedFree(ptr);
+  }
+
+  LargeAllocStats getLargeAllocStats()
+  {
+    LargeAllocStats stats;
+    stats.numBytes = 0;
+    stats.explicitHugeBytes = 0;
+    stats.transparentHugeBytes = 0;
+
+    embree::Lock<embree::MutexSys> lock(largeAllocMutex);
+    for (std::map<void *,LargeAlloc>::const_iterator it = largeAllocs.begin();
+         it != largeAllocs.end(); ++it) {
+      stats.numBytes += it->second.numBytes;
+      if (it->second.kind == LARGE_ALLOC_HUGETLB)
+        stats.explicitHugeBytes += it->second.numBytes;
+    }
+
+#ifdef __linux__
+    /* the kernel reports the transparent huge pages of each mapping
+       in /proc/self/smaps; mappings can span several (adjacent)
+       buffers, so only count the part overlapping our buffers */
+    FILE *smaps = fopen("/proc/self/smaps","r");
+    if (!smaps) return stats;
+    char line[512];
+    size_t vmaBegin = 0, vmaEnd = 0;
+    while (fgets(line,sizeof(line),smaps)) {
+      unsigned long begin, end, kB;
+      if (sscanf(line,"%lx-%lx ",&begin,&end) == 2) {
+        vmaBegin = begin;
+        vmaEnd   = end;
+      } else if (sscanf(line,"AnonHugePages: %lu kB",&kB) == 1 && kB > 0) {
+        size_t overlap = 0;
+        for (std::map<void *,LargeAlloc>::const_iterator it = largeAllocs.begin();
+             it != largeAllocs.end(); ++it) {
+          if (it->second.kind != LARGE_ALLOC_PAGES) continue;
+          const size_t b = std::max(vmaBegin,(size_t)it->first);
+          const size_t e = std::min(vmaEnd,(size_t)it->first+it->second.numBytes);
+          if (e > b) overlap += e-b;
+        }
+        stats.transparentHugeBytes += std::min(size_t(kB)*1024,overlap);
+      }
+    }
+    fclose(smaps);
+#endif
+    return stats;
+  }
+
+} // ::ospray
@@ -0,0 +1,59 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+/*! \file Memory.h Allocation of large buffers, backed by huge pages where possible */
+
+#include "OSPCommon.h"
+
+namespace ospray {
+
+  /*! size of the (x86) huge pages large buffers get backed with */
+  const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+
+  /*! \brief allocate memory for a potentially large buffer, such as
+      voxel data, data arrays, or frame buffers
+
+    Randomly accessed large buffers cause many TLB misses when backed
+    by regular 4KB pages. Buffers of at least HUGE_PAGE_SIZE bytes
+    therefore get backed by transparent huge pages where the kernel
+    can provide them, and by regular pages else. With --osp:hugetlb
+    (see explicitHugePages), they first try explicitly reserved huge
+    pages (see /proc/sys/vm/nr_hugepages). Such buffers are aligned to HUGE_PAGE_SIZE; smaller ones
+    come from embree::alignedMalloc() and are 64-byte aligned.
+
+    The memory has to be released with freeLarge(). Throws a
+    std::runtime_error if out of memory. */
+  void *allocLarge(size_t numBytes);
+
+  /*! \brief free memory returned by allocLarge(); NULL is ignored */
+  void freeLarge(void *ptr);
+
+  /*! \brief memory currently allocated through allocLarge() */
+  struct LargeAllocStats {
+    size_t numBytes;             /*!< all memory allocated */
+    size_t explicitHugeBytes;    /*!< ... backed by explicitly reserved huge pages */
+    size_t transparentHugeBytes; /*!< ... currently backed by transparent huge pages */
+  };
+
+  /*! \brief query how much memory allocLarge() got backed by huge
+      pages; for transparent huge pages, this depends on which parts
+      of the buffers have been touched yet */
+  LargeAllocStats getLargeAllocStats();
+
+} // ::ospray
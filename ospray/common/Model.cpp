@@ -30,7 +30,20 @@ namespace ospray {
   using std::cout;
   using std::endl;
 
+  /*! whether a geometry reported usable bounds; geometries that do
+      not compute them leave them empty */
+  static bool validBounds(const box3f &b)
+  {
+    for (int i=0;i<3;i++)
+      if (!(b.lower[i] <= b.upper[i])
+          || !(std::abs(b.lower[i]) < float(embree::inf))
+          || !(std::abs(b.upper[i]) < float(embree::inf)))
+        return false;
+    return true;
+  }
+
   Model::Model()
+    : boundsComplete(false)
   {
     managedObjectType = OSP_MODEL;
     this->ispcEquivalent = ispc::Model_create(this);
@@ -47,6 +60,7 @@ namespace ospray {
     embreeSceneHandle = (RTCScene)ispc::Model_getEmbreeSceneHandle(getIE());
 
     bounds = embree::empty;
+    boundsComplete = true;
 
     // for now, only implement triangular geometry...
     for (size_t i=0; i < geometry.size(); i++) {
@@ -58,8 +72,13 @@ namespace ospray {
 
       geometry[i]->finalize(this);
 
-      bounds.extend(geometry[i]->bounds);
-      ispc::Model_setGeometry(getIE(), i, geometry[i]->getIE());
+      if (validBounds(geometry[i]->bounds))
+        bounds.extend(geometry[i]->bounds);
+      else
+        boundsComplete = false;
+      ispc::Model_setGeometry(getIE(), i, geometry[i]->getIE(),
+                              (const ispc::vec3f&)geometry[i]->bounds.lower,
+                              (const ispc::vec3f&)geometry[i]->bounds.upper);
     }
 
     for (size_t i=0 ; i < volumes.size() ; i++) ispc::Model_setVolume(getIE(), i, volumes[i]->getIE());
@@ -50,7 +50,11 @@ namespace ospray {
 
     std::vector<Ref<Volume> > volumes;
 
+    /*! union of the bounds of all geometries that report them */
     box3f bounds;
+    /*! false if some geometry did not report (finite) bounds, such
+        that 'bounds' may miss parts of the model */
+    bool boundsComplete;
 
     //! \brief the embree scene handle for this geometry
     RTCScene embreeSceneHandle; 
@@ -0,0 +1,212 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "NUMA.h"
+#include "Memory.h"
+// std
+#include <stdio.h>
+#ifdef __linux__
+# include <sched.h>
+# include <unistd.h>
+# include <sys/syscall.h>
+#endif
+
+namespace ospray {
+  namespace numa {
+
+    /*! memory policies of the mbind() system call, see <numaif.h>;
+        we issue the system call directly so we do not need libnuma */
+    enum { MPOL_PREFERRED_ = 1, MPOL_INTERLEAVE_ = 3 };
+
+    /*! the NUMA topology, as reported in /sys/devices/system/node */
+    struct Topology {
+      /*! OS node ID for each (dense) node index */
+      std::vector<int> nodeID;
+      /*! logical CPUs of each node */
+      std::vector<std::vector<int> > cpus;
+      /*! node index of each logical CPU */
+      std::vector<size_t> nodeOfCPU;
+
+      Topology();
+
+      /*! parse a sysfs cpu list such as "0-15,32-47" */
+      static std::vector<int> parseCPUList(const char *list);
+    };
+
+    std::vector<int> Topology::parseCPUList(const char *list)
+    {
+      std::vector<int> result;
+      const char *s = list;
+      while (*s) {
+        char *end;
+        const int begin = strtol(s,&end,10);
+        if (end == s) break;
+        int last = begin;
+        s = end;
+        if (*s == '-') {
+          last = strtol(s+1,&end,10);
+          s = end;
+        }
+        for (int i=begin;i<=last;i++)
+          result.push_back(i);
+        if (*s == ',') s++;
+      }
+      return result;
+    }
+
+    Topology::Topology()
+    {
+#ifdef __linux__
+      // node IDs are usually, but not necessarily, consecutive
+      for (int id=0;id<1024;id++) {
+        char fileName[128];
+        sprintf(fileName,"/sys/devices/system/node/node%i/cpulist",id);
+        FILE *file = fopen(fileName,"r");
+        if (!file) continue;
+        char list[4096];
+        if (fgets(list,sizeof(list),file)) {
+          std::vector<int> nodeCPUs = parseCPUList(list);
+          if (!nodeCPUs.empty()) {
+            nodeID.push_back(id);
+            cpus.push_back(nodeCPUs);
+          }
+        }
+        fclose(file);
+      }
+#endif
+      if (cpus.empty()) {
+        // no topology information; treat the machine as a single node
+        nodeID.push_back(0);
+        cpus.push_back(std::vector<int>());
+        return;
+      }
+
+      for (size_t node=0;node<cpus.size();node++)
+        for (size_t i=0;i<cpus[node].size();i++) {
+          const size_t cpu = cpus[node][i];
+          if (cpu >= nodeOfCPU.size()) nodeOfCPU.resize(cpu+1,0);
+          nodeOfCPU[cpu] = node;
+        }
+
+      if (logLevel >= 1) {
+        std::cout << "#osp:numa: found " << cpus.size() << " NUMA node(s)" << std::endl;
+        for (size_t node=0;node<cpus.size();node++)
+          std::cout << "#osp:numa:   node " << nodeID[node] << ": "
+                    << cpus[node].size() << " logical CPUs" << std::endl;
+      }
+    }
+
+    static const Topology &topology()
+    {
+      static Topology topology;
+      return topology;
+    }
+
+    size_t numNodes()
+    {
+      return topology().cpus.size();
+    }
+
+    size_t currentNode()
+    {
+#ifdef __linux__
+      const Topology &topo = topology();
+      const int cpu = sched_getcpu();
+      if (cpu >= 0 && size_t(cpu) < topo.nodeOfCPU.size())
+        return topo.nodeOfCPU[cpu];
+#endif
+      return 0;
+    }
+
+    std::vector<ssize_t> interleavedCPUs()
+    {
+      const Topology &topo = topology();
+      std::vector<ssize_t> result;
+      for (size_t i=0;;i++) {
+        bool any = false;
+        for (size_t node=0;node<topo.cpus.size();node++)
+          if (i < topo.cpus[node].size()) {
+            result.push_back(topo.cpus[node][i]);
+            any = true;
+          }
+        if (!any) break;
+      }
+      return result;
+    }
+
+#ifdef __linux__
+    /*! apply the given memory policy for the given nodes to a range of pages */
+    static void bindPages(void *ptr, size_t numBytes, int mode,
+                          const std::vector<size_t> &nodes)
+    {
+      const size_t bitsPerWord = 8*sizeof(unsigned long);
+      std::vector<unsigned long> mask(1024/bitsPerWord,0);
+      for (size_t i=0;i<nodes.size();i++) {
+        const int id = topology().nodeID[nodes[i]];
+        mask[id/bitsPerWord] |= 1UL << (id%bitsPerWord);
+      }
+      if (syscall(SYS_mbind,ptr,numBytes,mode,&mask[0],mask.size()*bitsPerWord,0) != 0
+          && logLevel >= 1)
+        std::cout << "#osp:numa: could not apply memory policy" << std::endl;
+    }
+#endif
+
+    /* placement works at the granularity of (huge) pages, so only
+       buffers that allocLarge() backs by huge pages get placed;
+       smaller ones are not worth it anyway */
+
+    void *allocBlocked(size_t numBytes, size_t blockSize)
+    {
+      void *ptr = allocLarge(numBytes);
+#ifdef __linux__
+      if (numNodes() > 1 && numBytes >= HUGE_PAGE_SIZE) {
+        const size_t P = HUGE_PAGE_SIZE;
+        const size_t numBlocks = (numBytes+blockSize-1)/blockSize;
+        // the blocks of each node are consecutive, so one range per node
+        for (size_t begin=0;begin<numBlocks;) {
+          const size_t node = nodeOfBlock(begin,numBlocks);
+          size_t end = begin+1;
+          while (end < numBlocks && nodeOfBlock(end,numBlocks) == node) end++;
+          // pages straddling two nodes' ranges go to the lower node
+          const size_t b = (begin*blockSize+P-1)/P*P;
+          const size_t e = std::min((numBytes+P-1)/P*P,(end*blockSize+P-1)/P*P);
+          if (e > b)
+            bindPages((char*)ptr+b,e-b,MPOL_PREFERRED_,std::vector<size_t>(1,node));
+          begin = end;
+        }
+      }
+#endif
+      return ptr;
+    }
+
+    void *allocInterleaved(size_t numBytes)
+    {
+      void *ptr = allocLarge(numBytes);
+#ifdef __linux__
+      if (numNodes() > 1 && numBytes >= HUGE_PAGE_SIZE) {
+        std::vector<size_t> nodes;
+        for (size_t node=0;node<numNodes();node++)
+          nodes.push_back(node);
+        bindPages(ptr,(numBytes+HUGE_PAGE_SIZE-1)/HUGE_PAGE_SIZE*HUGE_PAGE_SIZE,
+                  MPOL_INTERLEAVE_,nodes);
+      }
+#endif
+      return ptr;
+    }
+
+  } // ::ospray::numa
+} // ::ospray
@@ -0,0 +1,62 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+/*! \file NUMA.h NUMA topology queries and node-aware memory allocation */
+
+#include "OSPCommon.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace numa {
+
+    /*! \brief number of NUMA nodes of this machine; 1 if the topology
+        cannot be queried */
+    size_t numNodes();
+
+    /*! \brief (dense) index of the NUMA node the calling thread is
+        currently running on */
+    size_t currentNode();
+
+    /*! \brief all logical CPUs of the machine, ordered round-robin
+        across the NUMA nodes
+
+        pinning worker thread i to the i'th entry spreads any number
+        of threads evenly across all sockets */
+    std::vector<ssize_t> interleavedCPUs();
+
+    /*! \brief NUMA node that allocBlocked() places block 'i' out of
+        'numBlocks' on
+
+        consecutive blocks are grouped into numNodes() equally large
+        ranges, one per node */
+    inline size_t nodeOfBlock(size_t i, size_t numBlocks)
+    { return i * numNodes() / numBlocks; }
+
+    /*! \brief allocLarge() 'numBytes' of memory, consisting of
+        consecutive blocks of 'blockSize' bytes that get placed on the
+        NUMA nodes specified by nodeOfBlock(); free with freeLarge() */
+    void *allocBlocked(size_t numBytes, size_t blockSize);
+
+    /*! \brief allocLarge() 'numBytes' of memory whose pages are
+        interleaved across all NUMA nodes; free with freeLarge() */
+    void *allocInterleaved(size_t numBytes);
+
+  } // ::ospray::numa
+} // ::ospray
@@ -30,6 +30,8 @@ namespace ospray {
   uint32 logLevel = 0;
   bool debugMode = false;
   uint32 numThreads = 0; //!< 0 for default number of Embree threads.
+  bool numaAware = false;
+  bool explicitHugePages = false;
 
   WarnOnce::WarnOnce(const std::string &s) 
     : s(s) 
@@ -101,6 +103,12 @@ namespace ospray {
       } else if (parm == "--osp:numthreads") {
         numThreads = atoi(av[i+1]);
         removeArgs(ac,av,i,2);
+      } else if (parm == "--osp:numa") {
+        numaAware = true;
+        removeArgs(ac,av,i,1);
+      } else if (parm == "--osp:hugetlb") {
+        explicitHugePages = true;
+        removeArgs(ac,av,i,1);
       } else {
         ++i;
       }
@@ -143,6 +151,14 @@ namespace ospray {
     case OSP_UCHAR2:    return sizeof(embree::Vec2<uint8>);
     case OSP_UCHAR3:    return sizeof(embree::Vec3<uint8>);
     case OSP_UCHAR4:    return sizeof(uint32);
+    case OSP_USHORT:    return sizeof(uint16);
+    case OSP_USHORT2:   return sizeof(embree::Vec2<uint16>);
+    case OSP_USHORT3:   return sizeof(embree::Vec3<uint16>);
+    case OSP_USHORT4:   return sizeof(embree::Vec4<uint16>);
+    case OSP_SHORT:     return sizeof(int16);
+    case OSP_SHORT2:    return sizeof(embree::Vec2<int16>);
+    case OSP_SHORT3:    return sizeof(embree::Vec3<int16>);
+    case OSP_SHORT4:    return sizeof(embree::Vec4<int16>);
     case OSP_INT:       return sizeof(int32);
     case OSP_INT2:      return sizeof(embree::Vec2<int32>);
     case OSP_INT3:      return sizeof(embree::Vec3<int32>);
@@ -164,6 +180,9 @@ namespace ospray {
     case OSP_FLOAT3:    return sizeof(embree::Vec3<float>);
     case OSP_FLOAT4:    return sizeof(embree::Vec4<float>);
     case OSP_FLOAT3A:   return sizeof(embree::Vec3fa);
+    case OSP_HALF:      return sizeof(uint16);
+    case OSP_BC1:       return 8;  // per 4x4 texel block
+    case OSP_BC3:       return 16; // per 4x4 texel block
     default: break;
     };
 
@@ -181,6 +200,9 @@ namespace ospray {
     if (strcmp(string, "float2") == 0) return(OSP_FLOAT2);
     if (strcmp(string, "float3") == 0) return(OSP_FLOAT2);
     if (strcmp(string, "float4") == 0) return(OSP_FLOAT2);
+    if (strcmp(string, "half"  ) == 0) return(OSP_HALF);
+    if (strcmp(string, "bc1"   ) == 0) return(OSP_BC1);
+    if (strcmp(string, "bc3"   ) == 0) return(OSP_BC3);
     if (strcmp(string, "int"   ) == 0) return(OSP_INT);
     if (strcmp(string, "int2"  ) == 0) return(OSP_INT2);
     if (strcmp(string, "int3"  ) == 0) return(OSP_INT3);
@@ -189,6 +211,14 @@ namespace ospray {
     if (strcmp(string, "uchar2") == 0) return(OSP_UCHAR2);
     if (strcmp(string, "uchar3") == 0) return(OSP_UCHAR3);
     if (strcmp(string, "uchar4") == 0) return(OSP_UCHAR4);
+    if (strcmp(string, "ushort") == 0) return(OSP_USHORT);
+    if (strcmp(string, "ushort2") == 0) return(OSP_USHORT2);
+    if (strcmp(string, "ushort3") == 0) return(OSP_USHORT3);
+    if (strcmp(string, "ushort4") == 0) return(OSP_USHORT4);
+    if (strcmp(string, "short") == 0) return(OSP_SHORT);
+    if (strcmp(string, "short2") == 0) return(OSP_SHORT2);
+    if (strcmp(string, "short3") == 0) return(OSP_SHORT3);
+    if (strcmp(string, "short4") == 0) return(OSP_SHORT4);
     if (strcmp(string, "uint"  ) == 0) return(OSP_UINT);
     if (strcmp(string, "uint2" ) == 0) return(OSP_UINT2);
     if (strcmp(string, "uint3" ) == 0) return(OSP_UINT3);
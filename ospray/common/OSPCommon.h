@@ -140,6 +140,10 @@ namespace ospray {
   extern bool debugMode;
   /*! number of Embree threads to use, 0 for the default number. (cmdline: --osp:numthreads \<n\>) */
   extern uint32 numThreads;
+  /*! whether to pin threads and place large buffers with respect to the NUMA topology (cmdline: --osp:numa) */
+  extern bool numaAware;
+  /*! whether large buffers may take explicitly reserved huge pages (cmdline: --osp:hugetlb) */
+  extern bool explicitHugePages;
 
   /*! error handling callback to be used by embree */
   //  void error_handler(const RTCError code, const char *str);
@@ -63,6 +63,22 @@ typedef enum {
   //! Single precision floating point scalar and vector types.
   OSP_FLOAT, OSP_FLOAT2, OSP_FLOAT3, OSP_FLOAT4, OSP_FLOAT3A,
 
+  // new types get appended here, right before OSP_UNKNOWN, such that
+  // the values of existing types (and binaries using them) stay valid
+
+  //! Unsigned 16-bit integer scalar and vector types.
+  OSP_USHORT, OSP_USHORT2, OSP_USHORT3, OSP_USHORT4,
+
+  //! Signed 16-bit integer scalar and vector types.
+  OSP_SHORT, OSP_SHORT2, OSP_SHORT3, OSP_SHORT4,
+
+  //! Half precision (IEEE 754 binary16) floating point scalar type.
+  OSP_HALF,
+
+  //! Block-compressed texel types (BC1 resp. BC3, a.k.a. DXT1/DXT5);
+  //! one item is a block of 4x4 texels. Only valid for textures.
+  OSP_BC1, OSP_BC3,
+
   //! Guard value.
   OSP_UNKNOWN,
 
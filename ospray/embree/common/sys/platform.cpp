@@ -87,6 +87,17 @@ namespace embree
 
 namespace embree
 {
+  /*! ask the kernel to back large mappings by transparent huge pages
+      (BVH nodes and primitive blocks are traversed randomly, so this
+      saves TLB misses); a failure just leaves the 4KB pages in place */
+  static void adviseHugePages(void* ptr, size_t bytes)
+  {
+#if !defined(__MIC__) && defined(MADV_HUGEPAGE)
+    if (bytes >= 2*1024*1024)
+      madvise(ptr,bytes,MADV_HUGEPAGE);
+#endif
+  }
+
   void* os_malloc(size_t bytes)
   {
     int flags = MAP_PRIVATE | MAP_ANON;
@@ -100,6 +111,7 @@ namespace embree
 #endif
     char* ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
     if (ptr == NULL || ptr == MAP_FAILED) throw std::bad_alloc();
+    adviseHugePages(ptr,bytes);
     return ptr;
   }
 
@@ -116,6 +128,7 @@ namespace embree
 #endif
     char* ptr = (char*) mmap(0, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
     if (ptr == NULL || ptr == MAP_FAILED) throw std::bad_alloc();
+    adviseHugePages(ptr,bytes);
     return ptr;
   }
 
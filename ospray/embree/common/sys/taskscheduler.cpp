@@ -39,6 +39,15 @@ namespace embree
   };
   
   TaskScheduler* TaskScheduler::instance = NULL;
+  std::vector<ssize_t> TaskScheduler::threadAffinities;
+
+  void TaskScheduler::setThreadAffinities(const std::vector<ssize_t>& affinities)
+  {
+    if (instance)
+      THROW_RUNTIME_ERROR("Embree threads already running.");
+
+    threadAffinities = affinities;
+  }
 
   void TaskScheduler::create(size_t numThreads)
   {
@@ -140,7 +149,8 @@ namespace embree
 
     /* generate all threads */
     for (size_t t=0; t<numThreads; t++) {
-      threads.push_back(createThread((thread_func)threadFunction,new Thread(t,numThreads,this),4*1024*1024,t));
+      const ssize_t affinity = t < threadAffinities.size() ? threadAffinities[t] : ssize_t(t);
+      threads.push_back(createThread((thread_func)threadFunction,new Thread(t,numThreads,this),4*1024*1024,affinity));
     }
 
     TaskLogger::init(numThreads);
@@ -144,6 +144,10 @@ namespace embree
     /*! returns the number of threads used */
     static size_t getNumThreads();
 
+    /*! sets the hardware threads the worker threads get pinned to,
+        thread i to affinities[i]; has to be called before create() */
+    static void setThreadAffinities(const std::vector<ssize_t>& affinities);
+
     /*! enables specified number of threads */
     static size_t enableThreads(size_t N);
 
@@ -194,6 +198,7 @@ namespace embree
 
     /* thread handling */
   protected:
+    static std::vector<ssize_t> threadAffinities;
     volatile bool terminateThreads;
     std::vector<thread_t> threads;
     bool defaultNumThreads;
@@ -14,192 +14,270 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+
 #include "taskscheduler_sys.h"
 #include "tasklogger.h"
- 
-#if 0
- 
+
 namespace embree
 {
-  TaskSchedulerSys::TaskSchedulerSys()
-    : begin(0), end(0), tasks(16*1024) {}
+  /*! index of the worker thread running on this thread, -1 for all other threads */
+  static __thread ssize_t workerIndex = -1;
 
-  void TaskSchedulerSys::add(ssize_t threadIndex, QUEUE queue, Task* task)
-  {
-    if (task->event) 
-      task->event->inc();
+  /*! number of unsuccessful attempts to find a task before an idle thread blocks */
+  static const size_t SPIN_COUNT = 2048;
 
-    mutex.lock();
+  bool TaskSchedulerSys::WorkQueue::push(Task* task)
+  {
+    const atomic_t b = bottom;
+    if (b-top >= SIZE) return false;
+    tasks[b&(SIZE-1)] = task;
+    __memory_barrier(); // stores are not reordered on x86, the task is visible before the new bottom
+    bottom = b+1;
+    return true;
+  }
 
-    /*! insert task to correct end of list */
-    switch (queue) {
-    case GLOBAL_FRONT: { size_t i = (--begin)&(tasks.size()-1); tasks[i] = task; break; }
-    case GLOBAL_BACK : { size_t i = (end++  )&(tasks.size()-1); tasks[i] = task; break; }
-    default          : THROW_RUNTIME_ERROR("invalid task queue");
+  TaskScheduler::Task* TaskSchedulerSys::WorkQueue::pop()
+  {
+    /* the atomic operation orders the store to bottom before the load of top */
+    const atomic_t b = atomic_add(&bottom,-1)-1;
+    const atomic_t t = top;
+    if (t > b) {
+      bottom = b+1;
+      return NULL;
+    }
+    Task* task = tasks[b&(SIZE-1)];
+    if (t == b) {
+      /* last task, race against the thieves */
+      if (atomic_cmpxchg(&top,t,t+1) != t) task = NULL;
+      bottom = b+1;
     }
-    
-    condition.broadcast();
-    mutex.unlock();
+    return task;
   }
 
-  void TaskSchedulerSys::run(size_t threadIndex, size_t threadCount)
+  TaskScheduler::Task* TaskSchedulerSys::WorkQueue::steal()
   {
-    while (true)
-    {      
-      /* wait for available task */
-      mutex.lock();
-      while ((end-begin) == 0 && !terminateThreads) {
-        condition.wait(mutex); continue;
-      }
-      
-      /* terminate this thread */
-      if (terminateThreads) {
-        mutex.unlock(); return;
-      }
-
-      /* take next task from stack */
-      size_t i = (end-1)&(tasks.size()-1);
-      Task* task = tasks[i]; 
-      if (task == NULL || task->started <= 0) {
-        tasks[i] = NULL; end--; mutex.unlock(); continue;
-      }
-      task->locks++;
-      mutex.unlock();
-
-      TaskScheduler::Event* event = task->event;
-      thread2event[threadIndex].event = event; 
+    const atomic_t t = top;
+    __memory_barrier();
+    const atomic_t b = bottom;
+    if (t >= b) return NULL;
+    Task* task = tasks[t&(SIZE-1)];
+    if (atomic_cmpxchg(&top,t,t+1) != t) return NULL;
+    return task;
+  }
 
-      /* run the task */
-      while (true) {
-        ssize_t elt = --task->started;
-        if (elt < 0) break;
-        if (task->run) task->run(task->runData,threadIndex,threadCount,elt,task->elts,task->event);
-      }
+  TaskSchedulerSys::TaskSchedulerSys()
+    : numQueues(0), begin(0), end(0), injected(16*1024), numInjected(0) {}
 
-      /* complete the task */
-      mutex.lock();
-      if (--task->locks == 0) {
-        tasks[i] = NULL;
-        mutex.unlock();
-        if (task->complete) task->complete(task->completeData,threadIndex,threadCount,task->event);
-        if (event) event->dec();
-      } 
-      else 
-        mutex.unlock();
-    }
+  TaskSchedulerSys::~TaskSchedulerSys()
+  {
+    for (size_t i=0; i<queues.size(); i++)
+      delete queues[i];
   }
 
-  void TaskSchedulerSys::terminate() 
+  void TaskSchedulerSys::createQueues(size_t threadCount)
   {
-    mutex.lock();
-    terminateThreads = true;
-    condition.broadcast(); 
-    mutex.unlock();
+    injectionMutex.lock();
+    if (numQueues == 0) {
+      for (size_t i=0; i<threadCount; i++)
+        queues.push_back(new WorkQueue);
+      __memory_barrier();
+      numQueues = threadCount;
+    }
+    injectionMutex.unlock();
   }
-}
-
-#else
-
-namespace embree
-{
-  TaskSchedulerSys::TaskSchedulerSys()
-    : begin(0), end(0), tasks(16*1024) {}
 
   void TaskSchedulerSys::add(ssize_t threadIndex, QUEUE queue, Task* task)
   {
+    if (queue != GLOBAL_FRONT && queue != GLOBAL_BACK)
+      THROW_RUNTIME_ERROR("invalid task queue");
+
     if (task->event) 
       task->event->inc();
 
-    mutex.lock();
+    /*! the queue entry holds a reference to the task, see release() */
+    task->completed++;
+
+    /*! worker threads add to their own queue */
+    if (queue == GLOBAL_BACK && workerIndex >= 0 && queues[workerIndex]->push(task)) {
+      wakeup();
+      return;
+    }
+
+    injectionMutex.lock();
 
     /*! resize array if too small */
-    if (end-begin == tasks.size())
+    if (end-begin == injected.size())
     {
-      size_t s0 = 1*tasks.size();
-      size_t s1 = 2*tasks.size();
-      tasks.resize(s1);
+      size_t s0 = 1*injected.size();
+      size_t s1 = 2*injected.size();
+      injected.resize(s1);
       for (size_t i=begin; i!=end; i++)
-        tasks[i&(s1-1)] = tasks[i&(s0-1)];
+        injected[i&(s1-1)] = injected[i&(s0-1)];
     }
 
     /*! insert task to correct end of list */
     switch (queue) {
-    case GLOBAL_FRONT: { size_t i = (--begin)&(tasks.size()-1); tasks[i] = task; break; }
-    case GLOBAL_BACK : { size_t i = (end++  )&(tasks.size()-1); tasks[i] = task; break; }
-    default          : THROW_RUNTIME_ERROR("invalid task queue");
+    case GLOBAL_FRONT: { size_t i = (--begin)&(injected.size()-1); injected[i] = task; break; }
+    case GLOBAL_BACK : { size_t i = (end++  )&(injected.size()-1); injected[i] = task; break; }
     }
-    
-    condition.broadcast();
-    mutex.unlock();
+    numInjected = end-begin;
+
+    injectionMutex.unlock();
+    wakeup();
   }
 
   void TaskSchedulerSys::wait(size_t threadIndex, size_t threadCount, Event* event)
   {
     event->dec();
     if (!isEnabled(threadIndex)) {
-      while (!event->triggered()); // FIXME: wait using events
+      while (!event->triggered()) _mm_pause(); // FIXME: wait using events
     }
     else {
       while (!event->triggered()) { // FIXME: wait using events
-	work(threadIndex,threadCount,false);
+        if (!work(threadIndex,threadCount)) _mm_pause();
       }
     }
   }
 
-  void TaskSchedulerSys::work(size_t threadIndex, size_t threadCount, bool wait)
+  TaskScheduler::Task* TaskSchedulerSys::findTask(size_t threadIndex)
   {
-    /* wait for available task */
-    mutex.lock();
-    while (((end-begin) == 0 && !terminateThreads) || !isEnabled(threadIndex)) {
-      if (wait) condition.wait(mutex);
-      else { mutex.unlock(); return; }
+    /* the most recently added task of this thread */
+    if (workerIndex >= 0) {
+      if (Task* task = queues[workerIndex]->pop())
+        return task;
     }
-    
-    /* terminate this thread */
-    if (terminateThreads) {
-      mutex.unlock();
-      return;
+
+    /* the most recently added task from outside */
+    if (numInjected) {
+      Task* task = NULL;
+      injectionMutex.lock();
+      if (end != begin) {
+        task = injected[(--end)&(injected.size()-1)];
+        numInjected = end-begin;
+      }
+      injectionMutex.unlock();
+      if (task) return task;
     }
-    
-    /* take next task from stack */
-    size_t i = (end-1)&(tasks.size()-1);
-    Task* task = tasks[i]; 
-    size_t elt = --task->started;
-    if (elt == 0) end--;
-    mutex.unlock();
-    
-    /* run the task */
-    TaskScheduler::Event* event = task->event;
-    if (task->run) {
-      size_t taskID = TaskLogger::beginTask(threadIndex,task->name,elt);
-      task->run(task->runData,threadIndex,numEnabledThreads,elt,task->elts,task->event);
-      TaskLogger::endTask(threadIndex,taskID);
+
+    /* the oldest task of some other thread */
+    const size_t N = numQueues;
+    const size_t first = workerIndex >= 0 ? workerIndex+1 : 0;
+    for (size_t i=0; i<N; i++) {
+      if (Task* task = queues[(first+i)%N]->steal())
+        return task;
     }
-    
-    /* complete the task */
-    if (--task->completed == 0) {
-      if (task->complete) {
-        size_t taskID = TaskLogger::beginTask(threadIndex,task->name,0);
-        task->complete(task->completeData,threadIndex,numEnabledThreads,task->event);
+    return NULL;
+  }
+
+  bool TaskSchedulerSys::work(size_t threadIndex, size_t threadCount)
+  {
+    Task* task = findTask(threadIndex);
+    if (task == NULL) return false;
+    execute(threadIndex,task);
+    return true;
+  }
+
+  void TaskSchedulerSys::execute(size_t threadIndex, Task* task)
+  {
+    WorkQueue* queue = workerIndex >= 0 ? queues[workerIndex] : NULL;
+
+    while (true)
+    {
+      /* claim the next element */
+      const ssize_t elt = --task->started;
+      if (elt < 0) break;
+
+      /* keep the task available to idle threads while elements are left; our
+         own reference keeps it alive, so the new one can be taken here */
+      if (elt > 0 && queue && queue->empty()) {
+        task->completed++;
+        if (queue->push(task)) wakeup();
+        else task->completed--;
+      }
+
+      /* run the element */
+      if (task->run) {
+        size_t taskID = TaskLogger::beginTask(threadIndex,task->name,elt);
+        task->run(task->runData,threadIndex,numEnabledThreads,elt,task->elts,task->event);
         TaskLogger::endTask(threadIndex,taskID);
       }
-      if (event) event->dec();
+      release(threadIndex,task);
     }
+
+    /* drop the reference we got with the task */
+    release(threadIndex,task);
+  }
+
+  void TaskSchedulerSys::release(size_t threadIndex, Task* task)
+  {
+    /* the completed counter counts the unfinished elements plus the
+       references to the task held by queues and threads */
+    if (--task->completed != 0) return;
+
+    TaskScheduler::Event* event = task->event;
+    if (task->complete) {
+      size_t taskID = TaskLogger::beginTask(threadIndex,task->name,0);
+      task->complete(task->completeData,threadIndex,numEnabledThreads,task->event);
+      TaskLogger::endTask(threadIndex,taskID);
+    }
+    if (event) event->dec();
+  }
+
+  void TaskSchedulerSys::wakeup()
+  {
+    epoch++;
+    if (numSleeping == 0) return;
+    sleepMutex.lock();
+    condition.broadcast(); 
+    sleepMutex.unlock();
+  }
+
+  void TaskSchedulerSys::sleep(atomic_t lastEpoch)
+  {
+    /* any task added after 'lastEpoch' got read has changed the epoch,
+       and wakeup() sees this thread as sleeping once the epoch is
+       checked below */
+    numSleeping++;
+    sleepMutex.lock();
+    while (epoch == lastEpoch && !terminateThreads)
+      condition.wait(sleepMutex);
+    sleepMutex.unlock();
+    numSleeping--;
   }
 
   void TaskSchedulerSys::run(size_t threadIndex, size_t threadCount)
   {
+    createQueues(threadCount);
+    workerIndex = threadIndex;
+
+    size_t idle = 0;
     while (!terminateThreads)
-      work(threadIndex,threadCount,true);
+    {
+      /* read the epoch before looking for tasks, see sleep() */
+      const atomic_t lastEpoch = epoch;
+      if (isEnabled(threadIndex) && work(threadIndex,threadCount)) {
+        idle = 0;
+        continue;
+      }
+
+      /* spin for a while, then block until tasks get added */
+      if (++idle < SPIN_COUNT) {
+        _mm_pause();
+        continue;
+      }
+      sleep(lastEpoch);
+      idle = 0;
+    }
+
+    workerIndex = -1;
   }
 
   void TaskSchedulerSys::terminate() 
   {
-    mutex.lock();
     terminateThreads = true;
+    epoch++;
+    sleepMutex.lock();
     condition.broadcast(); 
-    mutex.unlock();
+    sleepMutex.unlock();
   }
 }
-
-#endif
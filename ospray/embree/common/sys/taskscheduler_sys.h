@@ -14,6 +14,7 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+
 #pragma once
 
 #include "taskscheduler.h"
@@ -22,7 +23,15 @@
 
 namespace embree
 {
-  /*! Task scheduler implementing a stack of tasks. */
+  /*! Work-stealing task scheduler. Every thread owns a deque of task
+   *  references: the owner pushes and pops at the bottom, idle
+   *  threads steal from the top, all without locks. Elements of a
+   *  task are claimed by atomically decrementing the task's started
+   *  counter; a thread working on a task keeps a reference to it
+   *  published in its deque such that idle threads can join. Tasks
+   *  added from outside the worker threads go through a mutex
+   *  protected injection queue. Idle threads spin for a while before
+   *  they block. */
   class __hidden TaskSchedulerSys : public TaskScheduler
   {
   public:
@@ -30,16 +39,64 @@ namespace embree
     /*! construction */
     TaskSchedulerSys();
 
+    /*! destruction */
+    ~TaskSchedulerSys();
+
   private:
 
-    /*! only a single initial task can be added from the main thread */
+    /*! Chase-Lev deque of task references with fixed capacity */
+    class __aligned(64) WorkQueue
+    {
+    public:
+      ALIGNED_STRUCT;
+      enum { SIZE = 1024 };
+
+      WorkQueue () : top(0), bottom(0) {}
+
+      /*! adds a task at the bottom, owner thread only, fails if the queue is full */
+      bool push(Task* task);
+
+      /*! takes the task at the bottom, owner thread only */
+      Task* pop();
+
+      /*! takes the task at the top, any thread */
+      Task* steal();
+
+      /*! true if the queue holds no tasks */
+      __forceinline bool empty() const { return bottom <= top; }
+
+    private:
+      __aligned(64) volatile atomic_t top;
+      __aligned(64) volatile atomic_t bottom;
+      Task* volatile tasks[SIZE];
+    };
+
+    /*! adds a task from any thread; worker threads push GLOBAL_BACK
+     *  tasks onto their own deque (falling back to the injection
+     *  queue when it is full), all other tasks go through the
+     *  injection queue, GLOBAL_FRONT ones ahead of those waiting */
     void add(ssize_t threadIndex, QUEUE queue, Task* task);
 
     /*! waits for an event out of a task */
     void wait(size_t threadIndex, size_t threadCount, Event* event);
 
-    /*! processes next task */
-    void work(size_t threadIndex, size_t threadCount, bool wait);
+    /*! processes next task, returns false if none was found */
+    bool work(size_t threadIndex, size_t threadCount);
+
+    /*! finds a task: from the own queue, the injection queue, or by stealing */
+    Task* findTask(size_t threadIndex);
+
+    /*! claims and runs elements of a task the calling thread holds a reference to */
+    void execute(size_t threadIndex, Task* task);
+
+    /*! drops a reference to a task, completes the task on the last one */
+    void release(size_t threadIndex, Task* task);
+
+    /*! wakes up blocked threads after new tasks got added */
+    void wakeup();
+
+    /*! blocks the calling thread until new tasks may be available */
+    void sleep(atomic_t epoch);
 
     /*! thread function */
     void run(size_t threadIndex, size_t threadCount);
@@ -47,10 +104,21 @@ namespace embree
     /*! sets the terminate thread variable */
     void terminate();
     
+    /*! creates the queues of all worker threads (once) */
+    void createQueues(size_t threadCount);
+
   private:
-    MutexSys mutex;           //!< mutex to protect access to task list
-    ConditionSys condition;   //!< condition to signal new tasks
-    size_t begin,end;         //!< current range of tasks
-    std::vector<Task*> tasks; //!< queue of tasks
+    std::vector<WorkQueue*> queues; //!< one queue per worker thread
+    volatile size_t numQueues;      //!< number of queues, set once all got created
+
+    MutexSys injectionMutex;        //!< protects the injection queue
+    size_t begin,end;               //!< current range of injected tasks
+    std::vector<Task*> injected;    //!< tasks added by non-worker threads (or with full queues)
+    volatile atomic_t numInjected;  //!< number of injected tasks, read without lock
+
+    MutexSys sleepMutex;            //!< mutex to block idle threads with
+    ConditionSys condition;         //!< condition to signal new tasks
+    AtomicCounter epoch;            //!< incremented whenever tasks got added
+    AtomicCounter numSleeping;      //!< number of threads (about to be) blocked
   };
 }
@@ -15,10 +15,25 @@
 // ======================================================================== //
 
 #include "FrameBuffer.h"
+#include "ospray/common/Memory.h"
+#include "ospray/common/NUMA.h"
 #include "LocalFB_ispc.h"
+#include "Reprojection_ispc.h"
 
 namespace ospray {
 
+  /*! allocate one element of T per pixel of a frame buffer. When
+      placed, the rows of tiles get distributed across the NUMA nodes
+      the same way LocalTiledLoadBalancer prefers to render them */
+  template<typename T>
+  static T *allocPixels(const vec2i &size, bool numaPlaced)
+  {
+    const size_t numBytes = sizeof(T)*size.x*size.y;
+    if (!numaPlaced)
+      return (T*)allocLarge(numBytes);
+    return (T*)numa::allocBlocked(numBytes,sizeof(T)*size.x*TILE_SIZE);
+  }
+
   FrameBuffer::FrameBuffer(const vec2i &size,
                            ColorBufferFormat colorBufferFormat,
                            bool hasDepthBuffer,
@@ -27,7 +42,9 @@ namespace ospray {
       colorBufferFormat(colorBufferFormat),
       hasDepthBuffer(hasDepthBuffer),
       hasAccumBuffer(hasAccumBuffer),
-      accumID(-1)
+      accumID(-1),
+      previewSubsampling(0),
+      fullFrameTime(0.)
   {
     managedObjectType = OSP_FRAMEBUFFER;
     Assert(size.x > 0 && size.y > 0);
@@ -35,9 +52,10 @@ namespace ospray {
 
   void LocalFrameBuffer::clear(const uint32 fbChannelFlags)
   {
-    if (fbChannelFlags & OSP_FB_ACCUM) {
-      ispc::LocalFrameBuffer_clearAccum(getIE());
+    if (fbChannelFlags & (OSP_FB_ACCUM|OSP_FB_HISTORY)) {
+      ispc::LocalFrameBuffer_clearAccum(getIE(),fbChannelFlags & OSP_FB_HISTORY);
       accumID = 0;
+      previewSubsampling = 0;
     }
   }
 
@@ -45,8 +63,11 @@ namespace ospray {
                                      ColorBufferFormat colorBufferFormat,
                                      bool hasDepthBuffer,
                                      bool hasAccumBuffer, 
-                                     void *colorBufferToUse)
-    : FrameBuffer(size, colorBufferFormat, hasDepthBuffer, hasAccumBuffer)
+                                     void *colorBufferToUse,
+                                     bool hasHistoryBuffer)
+    : FrameBuffer(size, colorBufferFormat, hasDepthBuffer, hasAccumBuffer),
+      ownsColorBuffer(colorBufferToUse == NULL),
+      numaPlaced(numaAware && numa::numNodes() > 1)
   { 
     Assert(size.x > 0);
     Assert(size.y > 0);
@@ -59,10 +80,10 @@ namespace ospray {
         colorBuffer = NULL;
         break;
       case OSP_RGBA_F32:
-        colorBuffer = new vec4f[size.x*size.y];
+        colorBuffer = allocPixels<vec4f>(size,numaPlaced);
         break;
       case OSP_RGBA_I8:
-        colorBuffer = new uint32[size.x*size.y];
+        colorBuffer = allocPixels<uint32>(size,numaPlaced);
         break;
       default:
         throw std::runtime_error("color buffer format not supported");
@@ -70,37 +91,61 @@ namespace ospray {
     }
 
     if (hasDepthBuffer)
-      depthBuffer = new float[size.x*size.y];
+      depthBuffer = allocPixels<float>(size,numaPlaced);
     else
       depthBuffer = NULL;
     
     if (hasAccumBuffer)
-      accumBuffer = new vec4f[size.x*size.y];
+      accumBuffer = allocPixels<vec4f>(size,numaPlaced);
     else
       accumBuffer = NULL;
+
+    // reprojection continues from the accumulated image
+    if (hasHistoryBuffer && hasAccumBuffer) {
+      hitPosition   = allocPixels<vec4f>(size,numaPlaced);
+      historyWeight = allocPixels<float>(size,numaPlaced);
+      reprojColor   = allocPixels<vec4f>(size,numaPlaced);
+      reprojWeight  = allocPixels<float>(size,numaPlaced);
+      reprojDepth   = allocPixels<float>(size,numaPlaced);
+      reprojKey     = allocPixels<int64>(size,numaPlaced);
+      ispcReprojection = ispc::Reprojection_create((const ispc::vec2i&)size,
+                                                   accumBuffer,
+                                                   hitPosition,
+                                                   historyWeight,
+                                                   reprojColor,
+                                                   reprojWeight,
+                                                   reprojDepth,
+                                                   reprojKey);
+    } else {
+      hitPosition = reprojColor = NULL;
+      historyWeight = reprojWeight = reprojDepth = NULL;
+      reprojKey = NULL;
+      ispcReprojection = NULL;
+    }
+
     ispcEquivalent = ispc::LocalFrameBuffer_create(this,size.x,size.y,
                                                    colorBufferFormat,
                                                    colorBuffer,
                                                    depthBuffer,
-                                                   accumBuffer);
+                                                   accumBuffer,
+                                                   ispcReprojection);
   }
   
   LocalFrameBuffer::~LocalFrameBuffer() 
   {
-    if (depthBuffer) delete[] depthBuffer;
-
-    if (colorBuffer)
-      switch(colorBufferFormat) {
-      case OSP_RGBA_F32:
-        delete[] ((vec4f*)colorBuffer);
-        break;
-      case OSP_RGBA_I8:
-        delete[] ((uint32*)colorBuffer);
-        break;
-      default:
-        throw std::runtime_error("color buffer format not supported");
-      }
-    if (accumBuffer) delete[] accumBuffer;
+    freeLarge(depthBuffer);
+    if (ownsColorBuffer)
+      freeLarge(colorBuffer);
+    freeLarge(accumBuffer);
+    if (ispcReprojection) {
+      ispc::Reprojection_destroy(ispcReprojection);
+      freeLarge(hitPosition);
+      freeLarge(historyWeight);
+      freeLarge(reprojColor);
+      freeLarge(reprojWeight);
+      freeLarge(reprojDepth);
+      freeLarge(reprojKey);
+    }
   }
 
   const void *LocalFrameBuffer::mapDepthBuffer()
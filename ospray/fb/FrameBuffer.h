@@ -65,6 +65,17 @@ namespace ospray {
         changes that requires clearing the accumulation buffer. */
     int32 accumID;
 
+    /*! subsampling level (see Renderer::frameTimeBudget) of the
+        preview currently in this frame buffer; while this is >0 and
+        accumID is 0, the next frame refines that preview in place,
+        reusing its samples. 0 if there is nothing to refine. */
+    int32 previewSubsampling;
+
+    /*! time (in seconds) a full resolution frame into this frame
+        buffer is estimated to take, measured from the previous frame
+        (see Renderer::frameTimeBudget); 0 until measured */
+    double fullFrameTime;
+
     virtual void clear(const uint32 fbChannelFlags) = 0;
   };
 
@@ -76,12 +87,28 @@ namespace ospray {
                                NULL */
     float     *depthBuffer; /*!< one float per pixel, may be NULL */
     vec4f     *accumBuffer; /*!< one RGBA per pixel, may be NULL */
+    bool       ownsColorBuffer; /*!< false if the color buffer was
+                                   handed in by the creator */
+    bool       numaPlaced; /*!< whether the buffers were placed on
+                              NUMA nodes by tile rows (--osp:numa) */
+
+    /*! buffers of the temporal reprojection stage (see
+        fb/Reprojection.ih); all NULL unless the frame buffer was
+        created with OSP_FB_HISTORY */
+    vec4f     *hitPosition;  /*!< primary hit per pixel */
+    float     *historyWeight; /*!< history each pixel started from */
+    vec4f     *reprojColor;  /*!< history reprojected into the current view */
+    float     *reprojWeight;
+    float     *reprojDepth;
+    int64     *reprojKey;
+    void      *ispcReprojection; /*!< the ispc-side stage */
 
     LocalFrameBuffer(const vec2i &size,
                      ColorBufferFormat colorBufferFormat,
                      bool hasDepthBuffer,
                      bool hasAccumBuffer, 
-                     void *colorBufferToUse=NULL);
+                     void *colorBufferToUse=NULL,
+                     bool hasHistoryBuffer=false);
     virtual ~LocalFrameBuffer();
     
     virtual const void *mapColorBuffer();
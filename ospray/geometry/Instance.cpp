@@ -31,18 +31,26 @@ namespace ospray {
 
   void Instance::finalize(Model *model) 
   {
-    xfm.l.vx = getParam3f("xfm.l.vx",vec3f(1.f,0.f,0.f));
-    xfm.l.vy = getParam3f("xfm.l.vy",vec3f(0.f,1.f,0.f));
-    xfm.l.vz = getParam3f("xfm.l.vz",vec3f(0.f,0.f,1.f));
-    xfm.p   = getParam3f("xfm.p",vec3f(0.f,0.f,0.f));
+    // instances get re-finalized whenever their transform changes,
+    // so intern their parameter names only once
+    static const Atom xfm_l_vx("xfm.l.vx");
+    static const Atom xfm_l_vy("xfm.l.vy");
+    static const Atom xfm_l_vz("xfm.l.vz");
+    static const Atom xfm_p("xfm.p");
+    static const Atom modelParam("model");
 
-    instancedScene = (Model *)getParamObject("model",NULL);
+    xfm.l.vx = getParam3f(xfm_l_vx,vec3f(1.f,0.f,0.f));
+    xfm.l.vy = getParam3f(xfm_l_vy,vec3f(0.f,1.f,0.f));
+    xfm.l.vz = getParam3f(xfm_l_vz,vec3f(0.f,0.f,1.f));
+    xfm.p   = getParam3f(xfm_p,vec3f(0.f,0.f,0.f));
+
+    instancedScene = (Model *)getParamObject(modelParam,NULL);
     assert(instancedScene);
     embreeGeomID = rtcNewInstance(model->embreeSceneHandle,
                                   instancedScene->embreeSceneHandle);
 
     const box3f b = instancedScene->bounds;
-    if (b.empty()) {
+    if (b.empty() || !instancedScene->boundsComplete) {
 #if 1
       // for now, let's just issue a warning since not all ospray
       // geometries do properly set the boudning box yet. as soon as
@@ -54,25 +62,29 @@ namespace ospray {
       throw std::runtime_error("trying to instantiate a model that does"
                                " not have a valid bounding box");
 #endif
-    }
-    const vec3f v000(b.lower.x,b.lower.y,b.lower.z);
-    const vec3f v001(b.upper.x,b.lower.y,b.lower.z);
-    const vec3f v010(b.lower.x,b.upper.y,b.lower.z);
-    const vec3f v011(b.upper.x,b.upper.y,b.lower.z);
-    const vec3f v100(b.lower.x,b.lower.y,b.upper.z);
-    const vec3f v101(b.upper.x,b.lower.y,b.upper.z);
-    const vec3f v110(b.lower.x,b.upper.y,b.upper.z);
-    const vec3f v111(b.upper.x,b.upper.y,b.upper.z);
+      // bounds that miss parts of the instance would make renderers
+      // cull it wrongly; leave them empty such that they are not used
+      bounds = embree::empty;
+    } else {
+      const vec3f v000(b.lower.x,b.lower.y,b.lower.z);
+      const vec3f v001(b.upper.x,b.lower.y,b.lower.z);
+      const vec3f v010(b.lower.x,b.upper.y,b.lower.z);
+      const vec3f v011(b.upper.x,b.upper.y,b.lower.z);
+      const vec3f v100(b.lower.x,b.lower.y,b.upper.z);
+      const vec3f v101(b.upper.x,b.lower.y,b.upper.z);
+      const vec3f v110(b.lower.x,b.upper.y,b.upper.z);
+      const vec3f v111(b.upper.x,b.upper.y,b.upper.z);
 
-    bounds = embree::empty;
-    bounds.extend(xfmPoint(xfm,v000));
-    bounds.extend(xfmPoint(xfm,v001));
-    bounds.extend(xfmPoint(xfm,v010));
-    bounds.extend(xfmPoint(xfm,v011));
-    bounds.extend(xfmPoint(xfm,v100));
-    bounds.extend(xfmPoint(xfm,v101));
-    bounds.extend(xfmPoint(xfm,v110));
-    bounds.extend(xfmPoint(xfm,v111));
+      bounds = embree::empty;
+      bounds.extend(xfmPoint(xfm,v000));
+      bounds.extend(xfmPoint(xfm,v001));
+      bounds.extend(xfmPoint(xfm,v010));
+      bounds.extend(xfmPoint(xfm,v011));
+      bounds.extend(xfmPoint(xfm,v100));
+      bounds.extend(xfmPoint(xfm,v101));
+      bounds.extend(xfmPoint(xfm,v110));
+      bounds.extend(xfmPoint(xfm,v111));
+    }
 
     rtcSetTransform(model->embreeSceneHandle,embreeGeomID,
                     RTC_MATRIX_COLUMN_MAJOR,
@@ -0,0 +1,87 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+// ospray
+#include "QuantizedSpheres.h"
+#include "ospray/common/Data.h"
+#include "ospray/common/Model.h"
+// ispc-generated files
+#include "QuantizedSpheres_ispc.h"
+
+namespace ospray {
+
+  QuantizedSpheres::QuantizedSpheres()
+  {
+    this->ispcEquivalent = ispc::QuantizedSpheres_create(this);
+    _materialList = NULL;
+  }
+
+  void QuantizedSpheres::finalize(Model *model)
+  {
+    radius            = getParam1f("radius",0.01f);
+    materialID        = getParam1i("materialID",0);
+    spheresPerBlock   = getParam1i("spheres_per_block",65536);
+    positions         = getParamData("positions",NULL);
+    blocks            = getParamData("blocks",NULL);
+    attributes        = getParamData("attributes",NULL);
+    materialList      = getParamData("materialList",NULL);
+
+    if (positions.ptr == NULL)
+      throw std::runtime_error("#ospray:geometry/quantized_spheres: no 'positions' data specified");
+    if (blocks.ptr == NULL)
+      throw std::runtime_error("#ospray:geometry/quantized_spheres: no 'blocks' data specified");
+    if (spheresPerBlock <= 0)
+      throw std::runtime_error("#ospray:geometry/quantized_spheres: 'spheres_per_block' must be positive");
+
+    numSpheres = positions->numBytes / (3*sizeof(uint16));
+    numBlocks  = blocks->numBytes / sizeof(vec4f);
+    std::cout << "#osp: creating 'quantized_spheres' geometry, #spheres = " << numSpheres
+              << ", #blocks = " << numBlocks << std::endl;
+
+    // primIDs are passed around as 32-bit signed ints on the ispc side
+    if (numSpheres >= (1ULL << 31)) {
+      throw std::runtime_error("#ospray::QuantizedSpheres: too many spheres in this sphere geometry. Consider splitting this geometry in multiple geometries with fewer spheres");
+    }
+    if (numBlocks * spheresPerBlock < numSpheres)
+      throw std::runtime_error("#ospray:geometry/quantized_spheres: not enough 'blocks' for the given number of spheres");
+    if (attributes && attributes->numBytes < numSpheres)
+      throw std::runtime_error("#ospray:geometry/quantized_spheres: 'attributes' array is smaller than the number of spheres");
+
+    if (_materialList) {
+      free(_materialList);
+      _materialList = NULL;
+    }
+
+    if (materialList) {
+      void **ispcMaterials = (void**) malloc(sizeof(void*) * materialList->numItems);
+      for (int i=0;i<materialList->numItems;i++) {
+        Material *m = ((Material**)materialList->data)[i];
+        ispcMaterials[i] = m?m->getIE():NULL;
+      }
+      _materialList = (void*)ispcMaterials;
+    }
+    ispc::QuantizedSpheresGeometry_set(getIE(),model->getIE(),
+                                       positions->data,blocks->data,
+                                       attributes.ptr ? attributes->data : NULL,
+                                       _materialList,
+                                       materialList.ptr ? materialList->numItems : 0,
+                                       numSpheres,spheresPerBlock,
+                                       radius,materialID);
+  }
+
+  OSP_REGISTER_GEOMETRY(QuantizedSpheres,quantized_spheres);
+
+} // ::ospray
@@ -0,0 +1,92 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "Geometry.h"
+
+namespace ospray {
+  /*! @{ \ingroup ospray_module_streamlines */
+
+  /*! \defgroup geometry_quantized_spheres Quantized Spheres ("quantized_spheres")
+
+    \ingroup ospray_supported_geometries
+
+    \brief Geometry representing spheres with 16-bit quantized
+    centers and a shared radius
+
+    Implements a compressed variant of the \ref geometry_spheres
+    geometry that is meant for very large particle data sets. Instead
+    of three floats per center, each sphere stores three 16-bit
+    unsigned integers that are relative to the origin of the block
+    of spheres it belongs to; sphere 'i' belongs to block
+    'i/spheres_per_block'. Each block is described by a 'vec4f', with
+    the block origin in x/y/z and the size of one quantization step
+    in w, i.e., a sphere's center is decoded as
+
+    center = block.xyz + block.w * vec3f(position[i])
+
+    Centers are decoded on the fly during bounds computation and
+    intersection, so a sphere only costs 6 bytes (7 bytes with a
+    per-sphere attribute) instead of the 16 bytes of the "spheres"
+    geometry.
+
+    Parameters:
+    <dl>
+    <dt><code>float         radius = 0.01f</code></dt><dd>Radius common to all spheres</dd>
+    <dt><code>int32         materialID = 0</code></dt><dd>Material ID common to all spheres if no 'attributes' are specified</dd>
+    <dt><code>int32         spheres_per_block = 65536</code></dt><dd>Number of consecutive spheres sharing the same block</dd>
+    <dt><code>Data<ushort3> positions</code></dt><dd>Quantized sphere centers, relative to their block.</dd>
+    <dt><code>Data<float4>  blocks</code></dt><dd>Per-block origin (xyz) and quantization step (w).</dd>
+    <dt><code>Data<uchar>   attributes</code></dt><dd>Optional per-sphere 8-bit material ID, indexing into 'materialList'.</dd>
+    </dl>
+
+    The functionality for this geometry is implemented via the
+    \ref ospray::QuantizedSpheres class.
+
+  */
+
+  /*! \brief A geometry for a set of spheres with quantized centers
+
+    Implements the \ref geometry_quantized_spheres geometry
+
+  */
+  struct QuantizedSpheres : public Geometry {
+    //! \brief common function to help printf-debugging
+    virtual std::string toString() const { return "ospray::QuantizedSpheres"; }
+    /*! \brief integrates this geometry's primitives into the respective
+      model's acceleration structure */
+    virtual void finalize(Model *model);
+
+    float radius;   //!< radius common to all spheres
+    int32 materialID;
+
+    size_t numSpheres;
+    size_t numBlocks;
+    int32  spheresPerBlock; //!< num consecutive spheres per block
+
+    Ref<Data> positions;
+    Ref<Data> blocks;
+    Ref<Data> attributes;
+    Ref<Data> materialList;
+    void     *_materialList;
+
+    QuantizedSpheres();
+  };
+  /*! @} */
+
+} // ::ospray
+
@@ -62,6 +62,7 @@ namespace ospray {
     RTCScene embreeSceneHandle = model->embreeSceneHandle;
 
     vertexData = getParamData("vertex",getParamData("position"));
+    vertex1Data = getParamData("vertex.t1",getParamData("position.t1"));
     normalData = getParamData("vertex.normal",getParamData("normal"));
     colorData  = getParamData("vertex.color",getParamData("color"));
     texcoordData = getParamData("vertex.texcoord",getParamData("texcoord"));
@@ -79,6 +80,7 @@ namespace ospray {
 
     this->index = (int*)indexData->data;
     this->vertex = (float*)vertexData->data;
+    this->vertex1 = vertex1Data ? (float*)vertex1Data->data : NULL;
     this->normal = normalData ? (float*)normalData->data : NULL;
     this->color  = colorData ? (vec4f*)colorData->data : NULL;
     this->texcoord = texcoordData ? (vec2f*)texcoordData->data : NULL;
@@ -117,6 +119,10 @@ namespace ospray {
     default:
       throw std::runtime_error("unsupported trianglemesh.vertex data type");
     }
+    if (vertex1Data && (vertex1Data->type != vertexData->type ||
+                        vertex1Data->numItems != vertexData->numItems))
+      throw std::runtime_error("trianglemesh.vertex.t1 has to match "
+                               "trianglemesh.vertex in type and size");
     if (normalData) switch (normalData->type) {
     case OSP_FLOAT3:  numCompsInNor = 3; break;
     case OSP_FLOAT:
@@ -125,8 +131,24 @@ namespace ospray {
       throw std::runtime_error("unsupported trianglemesh.vertex.normal data type");
     }
 
+    if (numCompsInVtx == 3 && !vertexData->isPadded()) {
+      /* embree reads vertices with 16-byte loads, i.e., past the
+         last vec3f; only unpadded shared buffers need a padded copy */
+      if (logLevel >= 2)
+        cout << "#osp/trimesh: copying unpadded shared vertex buffer" << endl;
+      vertexData = new Data(vertexData->numItems,vertexData->type,vertexData->data,0);
+      this->vertex = (float*)vertexData->data;
+    }
+    if (vertex1Data && numCompsInVtx == 3 && !vertex1Data->isPadded()) {
+      vertex1Data = new Data(vertex1Data->numItems,vertex1Data->type,vertex1Data->data,0);
+      this->vertex1 = (float*)vertex1Data->data;
+    }
+
+    /* a second vertex array makes this a moving mesh: embree
+       interpolates between the two time steps by ray.time. The
+       model's scene is static, which only takes static geometries */
     eMesh = rtcNewTriangleMesh(embreeSceneHandle,RTC_GEOMETRY_STATIC,
-                               numTris,numVerts);
+                               numTris,numVerts,vertex1 ? 2 : 1);
 #ifndef NDEBUG
     {
       cout << "#osp/trimesh: Verifying index buffer ... " << endl;
@@ -148,6 +170,10 @@ namespace ospray {
             std::isnan(vertex[i+1]) || 
             std::isnan(vertex[i+2]))
           throw std::runtime_error("NaN in vertex coordinate! (broken input model, refusing to handle that)");
+        if (vertex1 && (std::isnan(vertex1[i+0]) || 
+                        std::isnan(vertex1[i+1]) || 
+                        std::isnan(vertex1[i+2])))
+          throw std::runtime_error("NaN in vertex.t1 coordinate! (broken input model, refusing to handle that)");
       }
     }    
 #endif
@@ -155,6 +181,10 @@ namespace ospray {
     rtcSetBuffer(embreeSceneHandle,eMesh,RTC_VERTEX_BUFFER,
                  (void*)this->vertex,0,
                  sizeOf(vertexData->type));
+    if (vertex1)
+      rtcSetBuffer(embreeSceneHandle,eMesh,RTC_VERTEX_BUFFER1,
+                   (void*)this->vertex1,0,
+                   sizeOf(vertex1Data->type));
     rtcSetBuffer(embreeSceneHandle,eMesh,RTC_INDEX_BUFFER,
                  (void*)this->index,0,
                  sizeOf(indexData->type));
@@ -163,11 +193,16 @@ namespace ospray {
     
     for (int i=0;i<numVerts*numCompsInVtx;i+=numCompsInVtx) 
       bounds.extend(*(vec3f*)(vertex + i));
+    // bound the whole motion, the triangles move linearly in between
+    if (vertex1)
+      for (int i=0;i<numVerts*numCompsInVtx;i+=numCompsInVtx) 
+        bounds.extend(*(vec3f*)(vertex1 + i));
 
     if (logLevel >= 2) 
       if (numPrints < 5) {
         cout << "  created triangle mesh (" << numTris << " tris "
-             << ", " << numVerts << " vertices)" << endl;
+             << ", " << numVerts << " vertices"
+             << (vertex1 ? ", moving" : "") << ")" << endl;
         cout << "  mesh bounds " << bounds << endl;
       } 
 
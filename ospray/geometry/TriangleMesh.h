@@ -33,6 +33,9 @@ namespace ospray {
     Once created, a trianglemesh recognizes the following parameters
     <pre>
     Data<vec3f> or Data<vec3fa> "position"        // vertex array
+    Data<vec3f> or Data<vec3fa> "position.t1"     // optional vertex array at the end of the
+                                                  // motion (ray time 1), same type and size
+                                                  // as "position"; makes the mesh motion blurred
     Data<vec3i> or Data<vec3ia> "index"           // index array (three int32 values per triangles)
                                                   // each int32 value is index into the vertex arrays
     Data<vec3f> or Data<vec3fa> "normal"          // vertex normals
@@ -55,6 +58,9 @@ namespace ospray {
     "trianglemesh", and has several parameters to specify its contained
     triangles; they are specified via data arrays of the proper form:
       -  a 'position' array (Data<vec3f> or Data<vec3fa> type)
+      -  optionally a 'position.t1' array of the same type and size,
+         holding the vertices at time 1 of a linear motion that starts
+         at 'position' at time 0 (see the camera's shutter interval)
       -  a 'normal' array (Data<vec3f> or Data<vec3fa> type)
       -  a 'color' array (Data<vec4f> type)
       -  a 'texcoord' array (Data<vec2f> type)
@@ -78,6 +84,7 @@ namespace ospray {
 
     const int    *index;  //!< mesh's triangle index array
     const float  *vertex; //!< mesh's vertex array
+    const float  *vertex1; //!< mesh's vertex array at time 1, NULL if the mesh does not move
     const float  *normal; //!< mesh's vertex normal array
     const vec4f  *color;  //!< mesh's vertex color array
     const vec2f  *texcoord; //!< mesh's vertex texcoord array
@@ -87,6 +94,7 @@ namespace ospray {
 
     Ref<Data> indexData;  /*!< triangle indices (A,B,C,materialID) */
     Ref<Data> vertexData; /*!< vertex position (vec3fa) */
+    Ref<Data> vertex1Data; /*!< vertex position at time 1 (vec3fa), or NULL */
     Ref<Data> normalData; /*!< vertex normal array (vec3fa) */
     Ref<Data> colorData;  /*!< vertex color array (vec3fa) */
     Ref<Data> texcoordData; /*!< vertex texcoord array (vec2f) */
@@ -86,7 +86,8 @@ typedef enum {
   OSP_FB_COLOR=(1<<0),
   OSP_FB_DEPTH=(1<<1),
   OSP_FB_ACCUM=(1<<2),
-  OSP_FB_ALPHA=(1<<3)
+  OSP_FB_ALPHA=(1<<3),
+  OSP_FB_HISTORY=(1<<4) /*!< reproject the accumulated image across accum clears; requires OSP_FB_ACCUM */
 } OSPFrameBufferChannel;
 
 /*! OSPRay constants for Frame Buffer creation ('and' ed together) */
@@ -108,8 +109,25 @@ typedef enum {
 /*! flags that can be passed to OSPNewData; can be OR'ed together */
 typedef enum {
   OSP_DATA_SHARED_BUFFER = (1<<0),
+  /*! the app guarantees that at least 16 bytes past the end of a
+      shared buffer are readable, so ospray can hand the buffer to
+      embree as is (embree reads vertices with 16-byte loads) */
+  OSP_DATA_PADDED_BUFFER = (1<<1),
 } OSPDataCreationFlags;
 
+/*! flags that can be passed to ospNewTexture2D, in addition to the
+    OSPDataCreationFlags; can be OR'ed together */
+typedef enum {
+  /*! (lossily) compress OSP_UCHAR3 resp. OSP_UCHAR4 texels into
+      OSP_BC1 resp. OSP_BC3 blocks, using 6x resp. 4x less memory */
+  OSP_TEXTURE_COMPRESS = (1<<4),
+} OSPTextureCreationFlags;
+
+/*! callback through which ospray hands a buffer passed to
+    ospNewSharedData() back to the app once it no longer references
+    it; 'userPtr' is the value passed to ospNewSharedData() */
+typedef void (*OSPDataReleaseFunc)(void *sharedData, void *userPtr);
+
 typedef enum {
   OSP_OK=0, /*! no error; any value other than zero means 'some kind of error' */
   OSP_GENERAL_ERROR /*! unspecified error */
@@ -149,6 +167,18 @@ extern "C" {
                       OSPRenderer renderer, 
                       const uint32 fbChannelFlags=OSP_FB_COLOR);
 
+  //! render a batch of frames concurrently (e.g., the views of a stereo or CAVE setup)
+  /*! Frame 'i' renders 'renderer[i]' into 'fb[i]'. 'camera' may be
+      NULL, as may be any of its entries; frames without a camera use
+      the camera of their renderer. The same renderer can appear
+      several times in a batch, but each frame buffer may only appear
+      once. */
+  void ospRenderFrames(int numFrames,
+                       const OSPFrameBuffer *fb,
+                       const OSPRenderer *renderer,
+                       const OSPCamera *camera,
+                       const uint32 fbChannelFlags=OSP_FB_COLOR);
+
   //! create a new renderer of given type 
   /*! return 'NULL' if that type is not known */
   OSPRenderer ospNewRenderer(const char *type);
@@ -200,7 +230,14 @@ extern "C" {
   OSPTransferFunction ospNewTransferFunction(const char * type);
   
   //! \brief create a new Texture2D with the given parameters
-  /*! \detailed return 'NULL' if the texture could not be created with the given parameters */
+  /*! \detailed return 'NULL' if the texture could not be created with the given parameters
+
+    For the block-compressed types OSP_BC1 and OSP_BC3, 'data' holds
+    rows of (width+3)/4 blocks of 4x4 texels each, (height+3)/4 rows,
+    i.e., the layout of the first mip level in a DDS file; their alpha
+    is opacity as usual, lookups return it as transparency (1-alpha)
+    like for all other textures. Pass OSP_TEXTURE_COMPRESS in 'flags'
+    to have uncompressed 8-bit data compressed instead. */
   OSPTexture2D ospNewTexture2D(int width, int height, OSPDataType type, void *data = NULL, int flags = 0);
 
   //! \brief lears the specified channel(s) of the frame buffer
@@ -209,6 +246,9 @@ extern "C" {
     if whichChannel&OSP_FB_COLOR!=0, clear the color buffer to '0,0,0,0'
     if whichChannel&OSP_FB_DEPTH!=0, clear the depth buffer to +inf
     if whichChannel&OSP_FB_ACCUM!=0, clear the accum buffer to 0,0,0,0, and reset accumID
+    if whichChannel&OSP_FB_HISTORY!=0, clear the accum buffer, and throw
+    away the history a frame buffer with OSP_FB_HISTORY would otherwise
+    reproject (e.g., when changing anything but the camera)
   */
   void ospFrameBufferClear(OSPFrameBuffer fb, const uint32 whichChannel);
 
@@ -225,9 +265,30 @@ extern "C" {
     - OSP_DATA_SHARED_BUFFER: indicates that the buffer can be shared with the app.
       In this case the calling program guarantees that the 'init' pointer will remain
       valid for the duration that this data array is being used.
+    - OSP_DATA_PADDED_BUFFER: only meaningful for shared buffers; the calling
+      program guarantees that at least 16 bytes past the end of 'init' are
+      readable. Geometries that pass unpadded shared buffers with a 12-byte
+      stride (e.g., Data<vec3f> vertex positions) to embree will otherwise
+      make a padded copy of that buffer.
    */
   OSPData ospNewData(size_t numItems, OSPDataType format, const void *init=NULL, int flags=0);
 
+  /*! create a new data buffer that takes over ownership of 'data'
+      without copying it
+
+    The buffer is always shared (i.e., OSP_DATA_SHARED_BUFFER is
+    implied; OSP_DATA_PADDED_BUFFER may be passed in 'flags'). Once the
+    data array's refcount drops to zero - i.e., once neither the app nor
+    any object that uses it holds a reference to it any more -
+    'releaseFunc' (if not NULL) gets called with 'data' and
+    'userPtr'. Devices that cannot share memory with the app (e.g.,
+    the MPI device) copy 'data' and call 'releaseFunc' before this
+    function returns.
+  */
+  OSPData ospNewSharedData(size_t numItems, OSPDataType format, void *data,
+                           OSPDataReleaseFunc releaseFunc, void *userPtr=NULL,
+                           int flags=0);
+
   /*! \} */
 
 
@@ -254,9 +315,16 @@ extern "C" {
 
     \param channelFlags specifies which channels the frame buffer has,
     and is or'ed together from the values OSP_FB_COLOR,
-    OSP_FB_DEPTH, and/or OSP_FB_ACCUM. If a certain buffer
+    OSP_FB_DEPTH, OSP_FB_ACCUM, and/or OSP_FB_HISTORY. If a certain buffer
     value is _not_ specified, the given buffer will not be present
     (see notes below).
+
+    With OSP_FB_HISTORY (and OSP_FB_ACCUM), clearing the accumulation
+    buffer does not throw away the image accumulated so far: the next
+    frame reprojects it into the new view, and pixels that still show
+    the same surface continue accumulating from it, using fewer
+    samples. This keeps the image converged while the camera moves;
+    for all other changes, clear with OSP_FB_HISTORY to start over.
     
     \param size size (in pixels) of frame buffer.
 
@@ -478,6 +546,24 @@ extern "C" {
   /*! \brief returns the world-space position of the geometry seen at [0-1] normalized screen-space pixel coordinates (if any) */
   void ospPick(OSPPickResult *result, OSPRenderer renderer, const osp::vec2f &screenPos);
 
+  /*! \brief additional information on a pick, optionally returned by ospPickBatch */
+  extern "C" typedef struct {
+    float t;    //< distance of the hit point along the pick ray (inf if no hit)
+    int geomID; //< ID of the geometry hit (-1 if none)
+    int primID; //< ID of the primitive hit within that geometry (-1 if none)
+    int instID; //< ID of the instance hit (-1 if none)
+  } OSPPickHitInfo;
+
+  /*! \brief picks 'numPositions' screen-space positions (as in
+      ospPick) in one call, writing one result per position to
+      'results' and, if not NULL, to 'hitInfo'.
+
+      All positions are traced in parallel, which is much cheaper than
+      as many calls to ospPick (in particular with the MPI device). */
+  void ospPickBatch(OSPRenderer renderer, size_t numPositions,
+                    const osp::vec2f *screenPos, OSPPickResult *results,
+                    OSPPickHitInfo *hitInfo=NULL);
+
   extern "C" /*OSP_DEPRECATED*/ typedef struct {
     bool hit;
     float world_x, world_y, world_z;
@@ -25,6 +25,7 @@
 #include "../render/Renderer.h"
 #include "../camera/Camera.h"
 #include "../volume/Volume.h"
+#include "../texture/Texture2D.h"
 #include "MPILoadBalancer.h"
 // std
 #include <unistd.h> // for fork()
@@ -950,7 +951,9 @@ namespace ospray {
       cmd.send((int32)fbChannelFlags);
       cmd.flush();
 
-      TiledLoadBalancer::instance->renderFrame(NULL,fb,fbChannelFlags);
+      // the master only collects tiles; it does not render itself
+      Ref<FrameContext> frame = new FrameContext(NULL,fb,fbChannelFlags);
+      TiledLoadBalancer::instance->renderFrame(frame.ptr);
     }
 
     //! release (i.e., reduce refcount of) given object
@@ -992,7 +995,7 @@ namespace ospray {
       cmd.send((int32)type);
       cmd.send((int32)flags);
       assert(data);
-      size_t size = ospray::sizeOf(type)*width*height;
+      size_t size = Texture2D::numBytes(width,height,type);
       cmd.send(size);
 
       cmd.send(data,size);
@@ -1004,6 +1007,31 @@ namespace ospray {
       cmd.flush();
       return (OSPTexture2D)(int64)handle;
     }
+
+    /*! pick many screen positions at once; the data is replicated, so
+        the first worker picks them all */
+    void MPIDevice::pickBatch(OSPRenderer _renderer, size_t numPositions,
+                              const vec2f *screenPos, OSPPickResult *results,
+                              OSPPickHitInfo *hitInfo)
+    {
+      Assert(_renderer);
+
+      cmd.newCommand(CMD_PICK_BATCH);
+      cmd.send((const mpi::Handle &)_renderer);
+      cmd.send(numPositions);
+      cmd.send((int32)(hitInfo != NULL));
+      cmd.send(screenPos,numPositions*sizeof(vec2f));
+      cmd.flush();
+
+      int32 failed = 0;
+      cmd.get_data(sizeof(failed), &failed, 0, mpi::worker.comm);
+      if (failed)
+        throw std::runtime_error("MPIDevice::pickBatch: picking failed on the workers");
+
+      cmd.get_data(numPositions*sizeof(OSPPickResult), results, 0, mpi::worker.comm);
+      if (hitInfo)
+        cmd.get_data(numPositions*sizeof(OSPPickHitInfo), hitInfo, 0, mpi::worker.comm);
+    }
     
   } // ::ospray::mpi
 } // ::ospray
@@ -63,6 +63,7 @@ namespace ospray {
         CMD_SET_VEC2F,
         CMD_SET_VEC3F,
         CMD_SET_VEC3I,
+        CMD_PICK_BATCH,
         CMD_USER
       } CommandTag;
 
@@ -237,6 +238,11 @@ namespace ospray {
       /*! create a new Texture2D object */
       virtual OSPTexture2D newTexture2D(int width, int height, 
                                         OSPDataType type, void *data, int flags);
+
+      /*! pick many screen positions at once, in one round trip to the workers */
+      virtual void pickBatch(OSPRenderer renderer, size_t numPositions,
+                             const vec2f *screenPos, OSPPickResult *results,
+                             OSPPickHitInfo *hitInfo);
     };
 
   } // ::ospray::api
@@ -29,10 +29,9 @@ namespace ospray {
       Master::Master() {
       }
 
-      void Master::renderFrame(Renderer *tiledRenderer,
-                               FrameBuffer *fb,
-                               const uint32 channelFlags)
+      void Master::renderFrame(FrameContext *frame)
       {
+        FrameBuffer *fb = frame->fb.ptr;
         int rc; 
         MPI_Status status;
 
@@ -70,9 +69,8 @@ namespace ospray {
                                      size_t threadCount, 
                                      TaskScheduler::Event* event) 
       {
-        renderer->endFrame(channelFlags);
-        renderer = NULL;
-        fb = NULL;
+        frame->renderer->endFrame(frame.ptr);
+        frame = NULL;
         // refDec();
       }
 
@@ -92,6 +90,7 @@ namespace ospray {
         if ((tileID % worker.size) != worker.rank) return;
 
         // PING;
+        FrameBuffer *fb = frame->fb.ptr;
         Tile __aligned(64) tile;
         const size_t tile_y = tileID / numTiles_x;
         const size_t tile_x = tileID - tile_y*numTiles_x;
@@ -101,8 +100,8 @@ namespace ospray {
         tile.region.upper.y = std::min(tile.region.lower.y+TILE_SIZE,fb->size.y);
         tile.fbSize = fb->size;
         tile.rcp_fbSize = rcp(vec2f(fb->size));
-        renderer->renderTile(tile);
-        ospray::LocalFrameBuffer *localFB = (ospray::LocalFrameBuffer *)fb.ptr;
+        frame->renderer->renderTile(frame.ptr,tile);
+        ospray::LocalFrameBuffer *localFB = (ospray::LocalFrameBuffer *)fb;
         uint32 rgba_i8[TILE_SIZE][TILE_SIZE];
         for (int iy=tile.region.lower.y;iy<tile.region.upper.y;iy++)
           for (int ix=tile.region.lower.x;ix<tile.region.upper.x;ix++) {
@@ -116,19 +115,15 @@ namespace ospray {
         MPI_Send(&rgba_i8,count,MPI_INT,0,tileID,app.comm);
       }
       
-      void Slave::renderFrame(Renderer *tiledRenderer, 
-                              FrameBuffer *fb,
-                              const uint32 channelFlags
-                              )
+      void Slave::renderFrame(FrameContext *frame)
       {
+        FrameBuffer *fb = frame->fb.ptr;
         Ref<RenderTask> renderTask
           = new RenderTask;//(fb,tiledRenderer->createRenderJob(fb));
-        renderTask->fb = fb;
-        renderTask->renderer = tiledRenderer;
+        renderTask->frame = frame;
         renderTask->numTiles_x = divRoundUp(fb->size.x,TILE_SIZE);
         renderTask->numTiles_y = divRoundUp(fb->size.y,TILE_SIZE);
-        renderTask->channelFlags = channelFlags;
-        tiledRenderer->beginFrame(fb);
+        frame->renderer->beginFrame(frame);
 
         /*! iw: using a local sync event for now; "in theory" we should be
           able to attach something like a sync event to the frame
@@ -37,9 +37,7 @@ namespace ospray {
       {
         Master();
         
-        virtual void renderFrame(Renderer *tiledRenderer,
-                                 FrameBuffer *fb,
-                                 const uint32 channelFlags);
+        virtual void renderFrame(FrameContext *frame);
         virtual std::string toString() const { return "ospray::mpi::staticLoadBalancer::Master"; };
       };
 
@@ -56,12 +54,10 @@ namespace ospray {
         
         /*! a task for rendering a frame using the global tiled load balancer */
         struct RenderTask : public embree::RefCount {
-          Ref<Renderer>                renderer;
-          Ref<FrameBuffer>             fb;
+          Ref<FrameContext>            frame;
           size_t                       numTiles_x;
           size_t                       numTiles_y;
           //          vec2i                        fbSize;
-          uint32                       channelFlags;
           embree::TaskScheduler::Task  task;
           
           TASK_RUN_FUNCTION(RenderTask,run);
@@ -76,9 +72,7 @@ namespace ospray {
         /*! total number of worker threads across all(!) slaves */
         int32 numTotalThreads;
         
-        virtual void renderFrame(Renderer *tiledRenderer, 
-                                 FrameBuffer *fb,
-                                 const uint32 channelFlags);
+        virtual void renderFrame(FrameContext *frame);
         virtual std::string toString() const { return "ospray::mpi::staticLoadBalancer::Slave"; };
       };
     }
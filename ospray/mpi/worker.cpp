@@ -374,7 +374,10 @@ namespace ospray {
           void *data = malloc(size);
           cmd.get_data(size,data);
 
-          texture2D = Texture2D::createTexture(width,height,(OSPDataType)type,data,flags);
+          // the received copy can not be shared with the app
+          texture2D = Texture2D::createTexture(width,height,(OSPDataType)type,data,
+                                               flags & ~OSP_DATA_SHARED_BUFFER);
+          free(data);
           assert(texture2D);
           handle.assign(texture2D);
         } break;
@@ -522,6 +525,39 @@ namespace ospray {
 
         } break;
 
+        case api::MPIDevice::CMD_PICK_BATCH: {
+          const mpi::Handle handle = cmd.get_handle();
+          const size_t numPositions = cmd.get_size_t();
+          const bool wantHitInfo = cmd.get_int32();
+          std::vector<vec2f> screenPos(numPositions);
+          cmd.get_data(numPositions*sizeof(vec2f),&screenPos[0]);
+
+          if (worker.rank == 0) {
+            Renderer *renderer = (Renderer*)handle.lookup();
+            Assert(renderer);
+
+            std::vector<OSPPickResult> results(numPositions);
+            std::vector<OSPPickHitInfo> hitInfo(wantHitInfo ? numPositions : 0);
+            // the app waits for a reply, so failures have to be sent, too
+            int32 failed = 0;
+            try {
+              renderer->pickBatch(numPositions,&screenPos[0],&results[0],
+                                  wantHitInfo ? &hitInfo[0] : NULL);
+            } catch (const std::exception &e) {
+              std::cerr << "#osp:mpi: pickBatch failed: " << e.what() << std::endl;
+              failed = 1;
+            }
+
+            cmd.send(&failed, sizeof(failed), 0, mpi::app.comm);
+            if (!failed) {
+              cmd.send(&results[0], numPositions*sizeof(OSPPickResult), 0, mpi::app.comm);
+              if (wantHitInfo)
+                cmd.send(&hitInfo[0], numPositions*sizeof(OSPPickHitInfo), 0, mpi::app.comm);
+            }
+            cmd.flush();
+          }
+        } break;
+
         case api::MPIDevice::CMD_SET_MATERIAL: {
           const mpi::Handle geoHandle = cmd.get_handle();
           const mpi::Handle matHandle = cmd.get_handle();
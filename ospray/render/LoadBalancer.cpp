@@ -16,6 +16,7 @@
 
 #include "LoadBalancer.h"
 #include "Renderer.h"
+#include "ospray/common/NUMA.h"
 
 namespace ospray {
 
@@ -28,9 +29,9 @@ namespace ospray {
                                                   size_t threadCount, 
                                                   TaskScheduler::Event* event) 
   {
-    renderer->endFrame(channelFlags);
-    renderer = NULL;
-    fb = NULL;
+    for (size_t i=0;i<frames.size();i++)
+      frames[i]->renderer->endFrame(frames[i].ptr);
+    frames.clear();
     // refDec();
   }
 
@@ -40,32 +41,99 @@ namespace ospray {
                                                size_t taskCount, 
                                                TaskScheduler::Event* event) 
   {
+    size_t frameID, tileID;
+    if (numNodes > 1)
+      claimTile(frameID,tileID);
+    else {
+      /* find the frame this tile belongs to; batches are small, so a
+         linear search is all we need */
+      frameID = 0;
+      while (taskIndex >= firstTile[frameID+1]) frameID++;
+      tileID = taskIndex - firstTile[frameID];
+    }
+    FrameContext *frame = frames[frameID].ptr;
+
     Tile tile;
-    const size_t tile_y = taskIndex / numTiles_x;
-    const size_t tile_x = taskIndex - tile_y*numTiles_x;
+    const size_t tile_y = tileID / numTiles_x[frameID];
+    const size_t tile_x = tileID - tile_y*numTiles_x[frameID];
     tile.region.lower.x = tile_x * TILE_SIZE;
     tile.region.lower.y = tile_y * TILE_SIZE;
-    tile.region.upper.x = std::min(tile.region.lower.x+TILE_SIZE,fb->size.x);
-    tile.region.upper.y = std::min(tile.region.lower.y+TILE_SIZE,fb->size.y);
-    renderer->renderTile(tile);
+    tile.region.upper.x = std::min(tile.region.lower.x+TILE_SIZE,frame->fb->size.x);
+    tile.region.upper.y = std::min(tile.region.lower.y+TILE_SIZE,frame->fb->size.y);
+    frame->renderer->renderTile(frame,tile);
 
   }
 
+  /*! every task element renders exactly one tile, but not
+      necessarily the one of its index: the tiles of each frame are
+      split into rows that match the NUMA placement of the frame
+      buffer (see numa::allocBlocked()), and threads first take tiles
+      from the rows of their own node before helping out on others */
+  void LocalTiledLoadBalancer::RenderTask::claimTile(size_t &frameID, size_t &tileID)
+  {
+    const size_t myNode = numa::currentNode();
+    for (size_t i=0;i<numNodes;i++) {
+      const size_t node = (myNode+i) % numNodes;
+      for (frameID=0;frameID<frames.size();frameID++) {
+        const size_t range = frameID*numNodes+node;
+        if (nextTile[range] >= (atomic_t)endTile[range]) continue;
+        tileID = atomic_add(&nextTile[range],1);
+        if (tileID < endTile[range]) return;
+      }
+    }
+    // there are exactly as many task elements as tiles
+    throw std::runtime_error("LocalTiledLoadBalancer: ran out of tiles");
+  }
+
   /*! render a frame via the tiled load balancer */
-  void LocalTiledLoadBalancer::renderFrame(Renderer *tiledRenderer,
-                                           FrameBuffer *fb,
-                                           const uint32 channelFlags)
+  void LocalTiledLoadBalancer::renderFrame(FrameContext *frame)
   {
-    Assert(tiledRenderer);
-    Assert(fb);
+    renderFrames(std::vector<Ref<FrameContext> >(1,frame));
+  }
+
+  /*! render a batch of frames via the tiled load balancer */
+  void LocalTiledLoadBalancer::renderFrames(const std::vector<Ref<FrameContext> > &frames)
+  {
+    if (frames.empty()) return;
 
     Ref<RenderTask> renderTask = new RenderTask;
-    renderTask->fb = fb;
-    renderTask->renderer = tiledRenderer;
-    renderTask->numTiles_x = divRoundUp(fb->size.x,TILE_SIZE);
-    renderTask->numTiles_y = divRoundUp(fb->size.y,TILE_SIZE);
-    renderTask->channelFlags = channelFlags;
-    tiledRenderer->beginFrame(fb);
+    renderTask->frames = frames;
+    renderTask->firstTile.push_back(0);
+    renderTask->numNodes = numaAware ? numa::numNodes() : 1;
+    for (size_t i=0;i<frames.size();i++) {
+      FrameContext *frame = frames[i].ptr;
+      Assert(frame);
+      Assert(frame->renderer);
+      Assert(frame->fb);
+      const size_t numTiles_x = divRoundUp(frame->fb->size.x,TILE_SIZE);
+      const size_t numTiles_y = divRoundUp(frame->fb->size.y,TILE_SIZE);
+      renderTask->numTiles_x.push_back(numTiles_x);
+      renderTask->firstTile.push_back(renderTask->firstTile.back()
+                                      + numTiles_x*numTiles_y);
+      if (renderTask->numNodes > 1)
+        for (size_t node=0;node<renderTask->numNodes;node++) {
+          // the rows of tiles placed on this node are consecutive
+          size_t begin = 0;
+          while (begin < numTiles_y && numa::nodeOfBlock(begin,numTiles_y) < node) begin++;
+          size_t end = begin;
+          while (end < numTiles_y && numa::nodeOfBlock(end,numTiles_y) == node) end++;
+          renderTask->nextTile.push_back(begin*numTiles_x);
+          renderTask->endTile.push_back(end*numTiles_x);
+        }
+      frame->renderer->beginFrame(frame);
+    }
+
+    // all frames of the batch render in the same time, split it by
+    // the number of pixels each one actually renders
+    std::vector<double> renderedPixels(frames.size());
+    double batchPixels = 0.;
+    for (size_t i=0;i<frames.size();i++) {
+      const vec2i &size = frames[i]->fb->size;
+      renderedPixels[i] = double(size.x)*size.y*frames[i]->renderedFraction();
+      batchPixels += renderedPixels[i];
+    }
+    for (size_t i=0;i<frames.size();i++)
+      frames[i].ptr->batchShare = renderedPixels[i] / batchPixels;
 
     /*! iw: using a local sync event for now; "in theory" we should be
         able to attach something like a sync event to the frame
@@ -81,7 +149,7 @@ namespace ospray {
       (&sync,
       // (&renderTask->fb->frameIsReadyEvent,
        renderTask->_run,renderTask.ptr,
-       renderTask->numTiles_x*renderTask->numTiles_y,
+       renderTask->firstTile.back(),
        renderTask->_finish,renderTask.ptr,
        "LocalTiledLoadBalancer::RenderTask");
     TaskScheduler::addTask(-1, TaskScheduler::GLOBAL_BACK, &renderTask->task); 
@@ -104,10 +172,10 @@ namespace ospray {
     const size_t tile_x = tileIndex - tile_y*numTiles_x;
     tile.region.lower.x = tile_x * TILE_SIZE;
     tile.region.lower.y = tile_y * TILE_SIZE;
-    tile.region.upper.x = std::min(tile.region.lower.x+TILE_SIZE,fb->size.x);
-    tile.region.upper.y = std::min(tile.region.lower.y+TILE_SIZE,fb->size.y);
+    tile.region.upper.x = std::min(tile.region.lower.x+TILE_SIZE,frame->fb->size.x);
+    tile.region.upper.y = std::min(tile.region.lower.y+TILE_SIZE,frame->fb->size.y);
 
-    renderer->renderTile(tile);
+    frame->renderer->renderTile(frame.ptr,tile);
   }
 
 
@@ -115,23 +183,20 @@ namespace ospray {
                                                   size_t threadCount, 
                                                   TaskScheduler::Event* event) 
   {
-    renderer->endFrame(channelFlags);
-    renderer = NULL;
-    fb = NULL;
+    frame->renderer->endFrame(frame.ptr);
+    frame = NULL;
     // refDec();
   }
 
   /*! render a frame via the tiled load balancer */
-  void InterleavedTiledLoadBalancer::renderFrame(Renderer *tiledRenderer,
-                                                 FrameBuffer *fb,
-                                                 const uint32 channelFlags)
+  void InterleavedTiledLoadBalancer::renderFrame(FrameContext *frame)
   {
-    Assert(tiledRenderer);
-    Assert(fb);
+    Assert(frame->renderer);
+    Assert(frame->fb);
 
+    FrameBuffer *fb = frame->fb.ptr;
     Ref<RenderTask> renderTask = new RenderTask;
-    renderTask->fb = fb;
-    renderTask->renderer = tiledRenderer;
+    renderTask->frame = frame;
     renderTask->numTiles_x = divRoundUp(fb->size.x,TILE_SIZE);
     renderTask->numTiles_y = divRoundUp(fb->size.y,TILE_SIZE);
     size_t numTiles_total = renderTask->numTiles_x*renderTask->numTiles_y;
@@ -139,10 +204,9 @@ namespace ospray {
     renderTask->numTiles_mine
       = (numTiles_total / numDevices)
       + (numTiles_total % numDevices > deviceID);
-    renderTask->channelFlags = channelFlags;
     renderTask->deviceID     = deviceID;
     renderTask->numDevices   = numDevices;
-    tiledRenderer->beginFrame(fb);
+    frame->renderer->beginFrame(frame);
     
     /*! iw: using a local sync event for now; "in theory" we should be
         able to attach something like a sync event to the frame
@@ -35,9 +35,12 @@ namespace ospray {
   {
     static TiledLoadBalancer *instance;
     virtual std::string toString() const = 0;
-    virtual void renderFrame(Renderer *tiledRenderer,
-                             FrameBuffer *fb,
-                             const uint32 channelFlags) = 0;
+    virtual void renderFrame(FrameContext *frame) = 0;
+    /*! render a batch of frames (e.g., the views of a stereo or CAVE
+        setup); load balancers that cannot render several frames
+        concurrently render them one after another */
+    virtual void renderFrames(const std::vector<Ref<FrameContext> > &frames)
+    { for (size_t i=0;i<frames.size();i++) renderFrame(frames[i].ptr); }
     // virtual void returnTile(FrameBuffer *fb, Tile &tile) = 0;
   };
 
@@ -48,22 +51,31 @@ namespace ospray {
     application ranks each doing local rendering on their own)  */ 
   struct LocalTiledLoadBalancer : public TiledLoadBalancer
   {
+    /*! a task rendering the tiles of all frames of a batch from one
+        common task pool, such that all threads stay busy until the
+        last tile of the last frame is done */
     struct RenderTask : public embree::RefCount {
-      Ref<FrameBuffer>             fb;
-      Ref<Renderer>                renderer;
-      
-      size_t                       numTiles_x;
-      size_t                       numTiles_y;
-      uint32                       channelFlags;
+      std::vector<Ref<FrameContext> > frames;
+      /*! index of the first tile of each frame in the task, plus the total number of tiles */
+      std::vector<size_t>          firstTile;
+      std::vector<size_t>          numTiles_x;
+      /*! with NUMA-aware placement (--osp:numa), the next and the end
+          tile of the rows of tiles of each frame whose frame buffer
+          pages are on a given node, indexed by frame*numNodes+node */
+      std::vector<atomic_t> nextTile;
+      std::vector<size_t>          endTile;
+      size_t                       numNodes;
       embree::TaskScheduler::Task  task;
 
+      /*! claim a tile, preferably one local to the caller's NUMA node */
+      void claimTile(size_t &frameID, size_t &tileID);
+
       TASK_RUN_FUNCTION(RenderTask,run);
       TASK_COMPLETE_FUNCTION(RenderTask,finish);
     };
 
-    virtual void renderFrame(Renderer *tiledRenderer, 
-                             FrameBuffer *fb,
-                             const uint32 channelFlags);
+    virtual void renderFrame(FrameContext *frame);
+    virtual void renderFrames(const std::vector<Ref<FrameContext> > &frames);
     virtual std::string toString() const { return "ospray::LocalTiledLoadBalancer"; };
   };
 
@@ -95,24 +107,20 @@ namespace ospray {
       attaching that as a sync primitive to the farme buffer
     */
     struct RenderTask : public embree::RefCount {
-      Ref<FrameBuffer>             fb;
-      Ref<Renderer>                renderer;
+      Ref<FrameContext>            frame;
       
       size_t                       numTiles_x;
       size_t                       numTiles_y;
       size_t                       numTiles_mine;
       size_t                       deviceID;
       size_t                       numDevices;
-      uint32                       channelFlags;
       embree::TaskScheduler::Task  task;
 
       TASK_RUN_FUNCTION(RenderTask,run);
       TASK_COMPLETE_FUNCTION(RenderTask,finish);
     };
     
-    virtual void renderFrame(Renderer *tiledRenderer, 
-                             FrameBuffer *fb,
-                             const uint32 channelFlags);
+    virtual void renderFrame(FrameContext *frame);
   };
 
 } // ::ospray
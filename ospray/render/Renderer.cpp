@@ -19,6 +19,8 @@
 #include "../common/Library.h"
 // stl 
 #include <map>
+#include <algorithm>
+#include <limits>
 // ispc exports
 #include "Renderer_ispc.h"
 // ospray
@@ -36,6 +38,7 @@ namespace ospray {
   {
     epsilon = getParam1f("epsilon", 1e-6f);
     spp = getParam1i("spp", 1);
+    frameTimeBudget = getParam1f("frameTimeBudget", 0.f);
     model = (Model*)getParamObject("model", getParamObject("world"));
     if (getIE()) {
       ManagedObject* camera = getParamObject("camera");
@@ -85,28 +88,107 @@ namespace ospray {
     return(renderer);
   }
 
-  void Renderer::renderTile(Tile &tile)
+  FrameContext::FrameContext(Renderer *renderer, FrameBuffer *fb,
+                             const uint32 channelFlags, ManagedObject *camera)
+    : renderer(renderer), fb(fb), camera(camera), channelFlags(channelFlags),
+      subsampling(0), previewSubsampling(0), startTime(0.), batchShare(1.)
   {
-    ispc::Renderer_renderTile(getIE(),(ispc::Tile&)tile);
+    Assert(fb);
+    ispcEquivalent = ispc::FrameContext_create(fb->getIE(),
+                                               camera ? camera->getIE() : NULL);
   }
 
-  void Renderer::beginFrame(FrameBuffer *fb) 
+  FrameContext::~FrameContext()
   {
-    this->currentFB = fb;
-    ispc::Renderer_beginFrame(getIE(),fb->getIE());
+    ispc::FrameContext_destroy(ispcEquivalent);
   }
 
-  void Renderer::endFrame(const int32 fbChannelFlags)
+  void Renderer::renderTile(FrameContext *frame, Tile &tile)
   {
-    FrameBuffer *fb = this->currentFB;
-    if ((fbChannelFlags & OSP_FB_ACCUM))
+    ispc::Renderer_renderTile(getIE(),frame->ispcEquivalent,(ispc::Tile&)tile);
+  }
+
+  /*! fraction of all pixels rendered by a frame that subsamples at
+      'level', refining a preview rendered at 'previewLevel' */
+  static double renderedFraction(int32 level, int32 previewLevel)
+  {
+    const double rendered = 1./(1 << 2*level);
+    return previewLevel > level ? rendered - 1./(1 << 2*previewLevel) : rendered;
+  }
+
+  double FrameContext::renderedFraction() const
+  {
+    return ospray::renderedFraction(subsampling,previewSubsampling);
+  }
+
+  void Renderer::selectSubsampling(FrameContext *frame) const
+  {
+    FrameBuffer *fb = frame->fb.ptr;
+    frame->subsampling = 0;
+    frame->previewSubsampling = 0;
+
+    // several samples per pixel always render at full resolution,
+    // as do all frames after the first one that got accumulated
+    if (spp > 1 || fb->accumID > 0)
+      return;
+
+    // coarsest level whose blocks still fit into a tile
+    int32 maxLevel = 0;
+    while ((2 << maxLevel) <= TILE_SIZE)
+      maxLevel++;
+
+    const double fullFrameTime = fb->fullFrameTime;
+    const bool measured = frameTimeBudget > 0.f && fullFrameTime > 0.;
+    if (fb->accumID == 0 && fb->previewSubsampling > 0) {
+      // refine the preview, as far as the budget allows
+      const int32 preview = std::min(fb->previewSubsampling,maxLevel);
+      int32 level = frameTimeBudget > 0.f ? preview-1 : 0;
+      while (level > 0 && measured
+             && renderedFraction(level-1,preview)*fullFrameTime <= frameTimeBudget)
+        level--;
+      frame->subsampling = level;
+      frame->previewSubsampling = preview;
+    } else if (frameTimeBudget > 0.f) {
+      // start a new preview, as fine as the budget allows
+      if (!measured)
+        return;
+      int32 level = 0;
+      while (level < maxLevel
+             && renderedFraction(level,0)*fullFrameTime > frameTimeBudget)
+        level++;
+      frame->subsampling = level;
+    } else if (spp < 0)
+      frame->subsampling = std::min(-spp,maxLevel);
+  }
+
+  void Renderer::beginFrame(FrameContext *frame) 
+  {
+    selectSubsampling(frame);
+    ispc::FrameContext_setSubsampling(frame->ispcEquivalent,
+                                      frame->subsampling,
+                                      frame->previewSubsampling);
+    frame->startTime = embree::getSeconds();
+    ispc::Renderer_beginFrame(getIE(),frame->ispcEquivalent);
+  }
+
+  void Renderer::endFrame(FrameContext *frame)
+  {
+    // estimate what a full resolution frame would have taken on its own
+    FrameBuffer *fb = frame->fb.ptr;
+    fb->fullFrameTime = (embree::getSeconds() - frame->startTime)
+      * frame->batchShare / frame->renderedFraction();
+
+    // a preview is not accumulated into, but refined at accumID 0
+    fb->previewSubsampling = fb->accumID >= 0 ? frame->subsampling : 0;
+    if ((frame->channelFlags & OSP_FB_ACCUM) && frame->subsampling == 0)
       fb->accumID++;
-    ispc::Renderer_endFrame(getIE(),fb->accumID);
+    ispc::Renderer_endFrame(getIE(),frame->ispcEquivalent,fb->accumID);
   }
   
   void Renderer::renderFrame(FrameBuffer *fb, const uint32 channelFlags)
   {
-    TiledLoadBalancer::instance->renderFrame(this,fb,channelFlags);
+    Ref<FrameContext> frame = new FrameContext(this,fb,channelFlags);
+    TiledLoadBalancer::instance->renderFrame(frame.ptr);
   }
 
   OSPPickResult Renderer::pick(const vec2f &screenPos)
@@ -120,4 +202,30 @@ namespace ospray {
     return res;
   }
 
+  void Renderer::pickBatch(size_t numPositions, const vec2f *screenPos,
+                           OSPPickResult *results, OSPPickHitInfo *hitInfo)
+  {
+    assert(getIE());
+    if (numPositions == 0) return;
+    if (!model || !getParamObject("camera"))
+      throw std::runtime_error("pickBatch() needs a renderer with a model and a camera");
+    if (numPositions > (size_t)std::numeric_limits<int32>::max())
+      throw std::runtime_error("too many positions passed to pickBatch()");
+
+    std::vector<PickResult> picked(numPositions);
+    ispc::Renderer_pickBatch(getIE(), numPositions,
+                             (const ispc::vec2f*)screenPos, &picked[0]);
+
+    for (size_t i=0;i<numPositions;i++) {
+      results[i].position = picked[i].position;
+      results[i].hit      = picked[i].hit;
+      if (hitInfo) {
+        hitInfo[i].t      = picked[i].t;
+        hitInfo[i].geomID = picked[i].geomID;
+        hitInfo[i].primID = picked[i].primID;
+        hitInfo[i].instID = picked[i].instID;
+      }
+    }
+  }
+
 } // ::ospray
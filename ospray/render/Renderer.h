@@ -25,6 +25,7 @@ namespace ospray {
 
   struct Material;
   struct Light;
+  struct FrameContext;
 
   /*! \brief abstract base class for all ospray renderers. 
 
@@ -34,7 +35,7 @@ namespace ospray {
     compositing or even projection/splatting based approaches
    */
   struct Renderer : public ManagedObject {
-    Renderer() : spp(1) {}
+    Renderer() : spp(1), frameTimeBudget(0.f) {}
 
     /*! \brief creates an abstract renderer class of given type 
 
@@ -53,13 +54,13 @@ namespace ospray {
     virtual void renderFrame(FrameBuffer *fb, const uint32 fbChannelFlags);
 
     /*! \brief called exactly once (on each node) at the beginning of each frame */
-    virtual void beginFrame(FrameBuffer *fb);
+    virtual void beginFrame(FrameContext *frame);
 
     /*! \brief called exactly once (on each node) at the end of each frame */
-    virtual void endFrame(const int32 fbChannelFlags);
+    virtual void endFrame(FrameContext *frame);
 
-    /*! \brief called by the load balancer to render one tile of "samples" */
-    virtual void renderTile(Tile &tile);
+    /*! \brief called by the load balancer to render one tile of "samples" of the given frame */
+    virtual void renderTile(FrameContext *frame, Tile &tile);
     
     /*! \brief create a material of given type */
     virtual Material *createMaterial(const char *type) { return NULL; }
@@ -69,14 +70,82 @@ namespace ospray {
 
     virtual OSPPickResult pick(const vec2f &screenPos);
 
+    /*! \brief pick many screen positions at once; 'hitInfo' may be NULL */
+    virtual void pickBatch(size_t numPositions, const vec2f *screenPos,
+                           OSPPickResult *results, OSPPickHitInfo *hitInfo);
+
     Model *model;
-    FrameBuffer *currentFB;
     
     /*! \brief parameter to prevent self-intersection issues, will be scaled with diameter of the scene */
     float epsilon;
 
     /*! \brief number of samples to be used per pixel in a tile */
     int32        spp;
+
+    /*! \brief target time (in seconds) for frames rendered during
+        interaction, 0 if none
+
+      \detailed With a budget, the first frame after the accumulation
+      buffer got cleared is a preview that renders only one sample per
+      2^k x 2^k pixel block, with k chosen such that the frame fits
+      the budget. The following frames refine that preview in place,
+      as fast as the budget allows, reusing the preview's samples, and
+      accumulation proceeds as usual once full resolution is reached.
+      Without a budget, a negative 'spp' selects k = -spp. */
+    float        frameTimeBudget;
+
+  protected:
+    /*! \brief picks the subsampling level of the given frame, and
+        the one of the preview it refines (if any) */
+    void selectSubsampling(FrameContext *frame) const;
+  };
+
+  /*! \brief result of picking one screen position, as computed on
+      the ispc side; has to match PickResult in Renderer.ispc */
+  struct PickResult {
+    vec3f position;
+    int32 hit;
+    float t;
+    int32 geomID;
+    int32 primID;
+    int32 instID;
+  };
+
+  /*! \brief the state of rendering one frame buffer with a renderer
+
+    \detailed All per-frame state lives here rather than in the
+    renderer, such that several frames can be in flight at the same
+    time, even for the same renderer (e.g., the two eyes of a stereo
+    pair, or the walls of a CAVE). */
+  struct FrameContext : public embree::RefCount {
+    /*! \brief 'camera' overrides the renderer's camera for this frame, if not NULL */
+    FrameContext(Renderer *renderer, FrameBuffer *fb,
+                 const uint32 channelFlags, ManagedObject *camera = NULL);
+    ~FrameContext();
+
+    Ref<Renderer>      renderer;
+    Ref<FrameBuffer>   fb;
+    Ref<ManagedObject> camera;
+    uint32             channelFlags;
+
+    /*! \brief render one sample per 2^subsampling x 2^subsampling block of pixels */
+    int32              subsampling;
+    /*! \brief subsampling of the preview in the frame buffer that
+        this frame refines, 0 if none */
+    int32              previewSubsampling;
+    /*! \brief time the frame was begun at, in seconds */
+    double             startTime;
+    /*! \brief share of the rendered pixels of the batch of frames
+        rendered together with this one (1 if rendered on its own);
+        only this share of the batch's time is spent on this frame */
+    double             batchShare;
+
+    /*! \brief fraction of the frame buffer's pixels this frame
+        renders; valid once the renderer began the frame */
+    double renderedFraction() const;
+
+    /*! \brief the ispc-side frame context */
+    void *ispcEquivalent;
   };
 
   /*! \brief registers a internal ospray::<ClassName> renderer under
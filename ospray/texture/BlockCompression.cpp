@@ -0,0 +1,235 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "BlockCompression.h"
+// std
+#include <string.h>
+
+namespace ospray {
+
+  inline void unpack565(uint16 c, uint8 rgb[3])
+  {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+  }
+
+  inline uint16 pack565(const float rgb[3])
+  {
+    const int r = std::max(0,std::min(31,int(rgb[0]*(31.f/255.f)+.5f)));
+    const int g = std::max(0,std::min(63,int(rgb[1]*(63.f/255.f)+.5f)));
+    const int b = std::max(0,std::min(31,int(rgb[2]*(31.f/255.f)+.5f)));
+    return (r << 11) | (g << 5) | b;
+  }
+
+  inline uint16 readU16(const uint8 *p) { return p[0] | (p[1] << 8); }
+  inline void writeU16(uint8 *p, uint16 v) { p[0] = v & 255; p[1] = v >> 8; }
+
+  /*! the four colors of a BC1 color block; 'forceFourColors' for BC3,
+      whose color blocks always use the four-color mode */
+  static void colorPalette(const uint8 *block, bool forceFourColors, uint8 palette[4][4])
+  {
+    const uint16 c0 = readU16(block), c1 = readU16(block+2);
+    unpack565(c0,palette[0]); palette[0][3] = 255;
+    unpack565(c1,palette[1]); palette[1][3] = 255;
+    if (c0 > c1 || forceFourColors) {
+      for (int i=0;i<3;i++) {
+        palette[2][i] = (2*palette[0][i] +   palette[1][i]) / 3;
+        palette[3][i] = (  palette[0][i] + 2*palette[1][i]) / 3;
+      }
+      palette[2][3] = palette[3][3] = 255;
+    } else {
+      for (int i=0;i<3;i++) {
+        palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+        palette[3][i] = 0;
+      }
+      palette[2][3] = 255;
+      palette[3][3] = 0;
+    }
+  }
+
+  static void decodeColors(const uint8 *block, bool forceFourColors, uint8 rgba[16*4])
+  {
+    uint8 palette[4][4];
+    colorPalette(block,forceFourColors,palette);
+    const uint32 bits = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32(block[7]) << 24);
+    for (int t=0;t<16;t++)
+      memcpy(rgba+4*t,palette[(bits >> (2*t)) & 3],4);
+  }
+
+  /*! the eight alpha values of a BC3 alpha block */
+  static void alphaPalette(const uint8 *block, uint8 palette[8])
+  {
+    const int a0 = block[0], a1 = block[1];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+      for (int i=1;i<7;i++)
+        palette[i+1] = ((7-i)*a0 + i*a1) / 7;
+    } else {
+      for (int i=1;i<5;i++)
+        palette[i+1] = ((5-i)*a0 + i*a1) / 5;
+      palette[6] = 0;
+      palette[7] = 255;
+    }
+  }
+
+  void decodeBC1(const uint8 *block, uint8 rgba[16*4])
+  {
+    decodeColors(block,false,rgba);
+  }
+
+  void decodeBC3(const uint8 *block, uint8 rgba[16*4])
+  {
+    decodeColors(block+8,true,rgba);
+
+    uint8 palette[8];
+    alphaPalette(block,palette);
+    uint64 bits = 0;
+    for (int i=0;i<6;i++)
+      bits |= uint64(block[2+i]) << (8*i);
+    for (int t=0;t<16;t++)
+      rgba[4*t+3] = palette[(bits >> (3*t)) & 7];
+  }
+
+  /*! encodes the colors of the 16 texels into 'block': endpoints are
+      the extreme texels along the principal axis of the (opaque)
+      colors, every texel gets the closest palette entry */
+  static void encodeColors(const uint8 rgba[16*4], bool allowTransparent, uint8 *block)
+  {
+    bool transparent[16];
+    bool anyTransparent = false;
+    float mean[3] = { 0.f, 0.f, 0.f };
+    int numOpaque = 0;
+    for (int t=0;t<16;t++) {
+      transparent[t] = allowTransparent && rgba[4*t+3] < 128;
+      anyTransparent |= transparent[t];
+      if (transparent[t]) continue;
+      for (int i=0;i<3;i++) mean[i] += rgba[4*t+i];
+      numOpaque++;
+    }
+
+    memset(block,0,BC1_BLOCK_BYTES);
+    if (numOpaque == 0) {
+      // all transparent: three-color mode (c0 == c1), index 3 everywhere
+      memset(block+4,0xff,4);
+      return;
+    }
+    for (int i=0;i<3;i++) mean[i] /= numOpaque;
+
+    // principal axis of the color covariance, by power iteration
+    float cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+    for (int t=0;t<16;t++) {
+      if (transparent[t]) continue;
+      const float r = rgba[4*t+0]-mean[0], g = rgba[4*t+1]-mean[1], b = rgba[4*t+2]-mean[2];
+      cov[0] += r*r; cov[1] += r*g; cov[2] += r*b;
+      cov[3] += g*g; cov[4] += g*b; cov[5] += b*b;
+    }
+    float axis[3] = { 1.f, 1.f, 1.f };
+    for (int iter=0;iter<4;iter++) {
+      const float x = cov[0]*axis[0] + cov[1]*axis[1] + cov[2]*axis[2];
+      const float y = cov[1]*axis[0] + cov[3]*axis[1] + cov[4]*axis[2];
+      const float z = cov[2]*axis[0] + cov[4]*axis[1] + cov[5]*axis[2];
+      const float len = std::max(std::max(fabsf(x),fabsf(y)),fabsf(z));
+      if (len == 0.f) break;
+      axis[0] = x/len; axis[1] = y/len; axis[2] = z/len;
+    }
+
+    // extreme texels along that axis become the endpoints
+    float minProj = 1e20f, maxProj = -1e20f;
+    float lo[3], hi[3];
+    for (int t=0;t<16;t++) {
+      if (transparent[t]) continue;
+      const float proj
+        = rgba[4*t+0]*axis[0] + rgba[4*t+1]*axis[1] + rgba[4*t+2]*axis[2];
+      if (proj < minProj) { minProj = proj; for (int i=0;i<3;i++) lo[i] = rgba[4*t+i]; }
+      if (proj > maxProj) { maxProj = proj; for (int i=0;i<3;i++) hi[i] = rgba[4*t+i]; }
+    }
+    uint16 c0 = pack565(hi), c1 = pack565(lo);
+
+    // four-color mode needs c0 > c1, three-color mode c0 <= c1
+    if (anyTransparent ? (c0 > c1) : (c0 < c1)) std::swap(c0,c1);
+    if (!anyTransparent && c0 == c1) {
+      // flat block: index 0 everywhere
+      writeU16(block,c0);
+      writeU16(block+2,c1);
+      return;
+    }
+    writeU16(block,c0);
+    writeU16(block+2,c1);
+
+    uint8 palette[4][4];
+    colorPalette(block,false,palette);
+    uint32 bits = 0;
+    for (int t=0;t<16;t++) {
+      int best = 3;
+      if (!transparent[t]) {
+        int bestDist = 1<<30;
+        for (int p=0;p<(anyTransparent?3:4);p++) {
+          int dist = 0;
+          for (int i=0;i<3;i++) {
+            const int d = int(rgba[4*t+i]) - int(palette[p][i]);
+            dist += d*d;
+          }
+          if (dist < bestDist) { bestDist = dist; best = p; }
+        }
+      }
+      bits |= uint32(best) << (2*t);
+    }
+    block[4] = bits & 255;
+    block[5] = (bits >> 8) & 255;
+    block[6] = (bits >> 16) & 255;
+    block[7] = (bits >> 24) & 255;
+  }
+
+  void encodeBC1(const uint8 rgba[16*4], uint8 *block)
+  {
+    encodeColors(rgba,true,block);
+  }
+
+  void encodeBC3(const uint8 rgba[16*4], uint8 *block)
+  {
+    // alpha: eight-level mode spanning the block's alpha range
+    int a0 = 0, a1 = 255;
+    for (int t=0;t<16;t++) {
+      a0 = std::max(a0,int(rgba[4*t+3]));
+      a1 = std::min(a1,int(rgba[4*t+3]));
+    }
+    memset(block,0,8);
+    block[0] = a0;
+    block[1] = a1;
+    if (a0 > a1) {
+      uint8 palette[8];
+      alphaPalette(block,palette);
+      uint64 bits = 0;
+      for (int t=0;t<16;t++) {
+        int best = 0, bestDist = 256;
+        for (int p=0;p<8;p++) {
+          const int dist = abs(int(rgba[4*t+3]) - int(palette[p]));
+          if (dist < bestDist) { bestDist = dist; best = p; }
+        }
+        bits |= uint64(best) << (3*t);
+      }
+      for (int i=0;i<6;i++)
+        block[2+i] = (bits >> (8*i)) & 255;
+    }
+
+    encodeColors(rgba,false,block+8);
+  }
+
+} // ::ospray
@@ -0,0 +1,44 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+/*! \file BlockCompression.h CPU encoder and decoder for the BC1 and
+    BC3 (a.k.a. DXT1 and DXT5) block-compressed texel formats, used
+    by Texture2D to build the mip levels of compressed textures. The
+    texture lookups themselves decode on the fly in Texture2D.ispc. */
+
+#include "ospray/common/OSPCommon.h"
+
+namespace ospray {
+
+  /*! bytes per 4x4 texel block of OSP_BC1 resp. OSP_BC3 */
+  const size_t BC1_BLOCK_BYTES = 8;
+  const size_t BC3_BLOCK_BYTES = 16;
+
+  /*! decodes one BC1 block into 16 RGBA8 texels (row-major) */
+  void decodeBC1(const uint8 *block, uint8 rgba[16*4]);
+  /*! decodes one BC3 block into 16 RGBA8 texels (row-major) */
+  void decodeBC3(const uint8 *block, uint8 rgba[16*4]);
+
+  /*! encodes 16 RGBA8 texels (row-major) into one BC1 block; texels
+      with alpha < 128 become transparent black */
+  void encodeBC1(const uint8 rgba[16*4], uint8 *block);
+  /*! encodes 16 RGBA8 texels (row-major) into one BC3 block */
+  void encodeBC3(const uint8 rgba[16*4], uint8 *block);
+
+} // ::ospray
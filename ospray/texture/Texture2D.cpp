@@ -14,55 +14,291 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+
 #include "Texture2D.h"
+#include "texelTileSize.h"
+#include "BlockCompression.h"
 #include "Texture2D_ispc.h"
+// std
+#include <vector>
 
 namespace ospray {
 
+  /*! converts an averaged channel value back to the texel type */
+  template<typename T> inline T toChannel(float f);
+  template<> inline unsigned char toChannel<unsigned char>(float f) { return (unsigned char)(f+.5f); }
+  template<> inline float toChannel<float>(float f) { return f; }
+
+  /*! box-filters the N-channel level 'src' of size sx*sy down to the
+      next mip level 'dst' of size dx*dy (odd sizes clamp the last
+      row/column) */
+  template<typename T, int N>
+  void downsample(const T *src, int sx, int sy, T *dst, int dx, int dy)
+  {
+    for (int y=0;y<dy;y++) {
+      const int y0 = std::min(2*y,sy-1), y1 = std::min(2*y+1,sy-1);
+      for (int x=0;x<dx;x++) {
+        const int x0 = std::min(2*x,sx-1), x1 = std::min(2*x+1,sx-1);
+        for (int c=0;c<N;c++) {
+          const float sum
+            = float(src[N*(y0*sx+x0)+c]) + float(src[N*(y0*sx+x1)+c])
+            + float(src[N*(y1*sx+x0)+c]) + float(src[N*(y1*sx+x1)+c]);
+          dst[N*(y*dx+x)+c] = toChannel<T>(.25f*sum);
+        }
+      }
+    }
+  }
+
+  /*! number of texels a level of size sx*sy occupies once tiled */
+  inline size_t tiledTexels(int sx, int sy)
+  {
+    const size_t tilesX = (sx+TEXEL_TILE_SIZE-1) >> TEXEL_TILE_BITS;
+    const size_t tilesY = (sy+TEXEL_TILE_SIZE-1) >> TEXEL_TILE_BITS;
+    return (tilesX*tilesY) << (2*TEXEL_TILE_BITS);
+  }
+
+  /*! copies the row-major N-channel level 'src' into its tiled
+      location 'dst' */
+  template<typename T, int N>
+  void tile(const T *src, int sx, int sy, T *dst)
+  {
+    const int tilesX = (sx+TEXEL_TILE_SIZE-1) >> TEXEL_TILE_BITS;
+    for (int y=0;y<sy;y++)
+      for (int x=0;x<sx;x++) {
+        const size_t tileID = size_t(y >> TEXEL_TILE_BITS)*tilesX + (x >> TEXEL_TILE_BITS);
+        const size_t texel
+          = (tileID << (2*TEXEL_TILE_BITS))
+          + ((y & (TEXEL_TILE_SIZE-1)) << TEXEL_TILE_BITS)
+          + (x & (TEXEL_TILE_SIZE-1));
+        for (int c=0;c<N;c++)
+          dst[N*texel+c] = src[N*(size_t(y)*sx+x)+c];
+      }
+  }
+
+  /*! offsets of the tiled mip levels within the pyramid; level l has
+      size max(1,sx>>l) x max(1,sy>>l), as assumed by Texture2D_create
+      on the ISPC side. A shared level 0 takes no space in the pyramid.
+      Returns the number of texels of the pyramid. */
+  size_t levelOffsets(int sx, int sy, bool sharedLevel0,
+                      std::vector<uint32> &levelOffset)
+  {
+    size_t numTexels = 0;
+    for (int l=0;;l++) {
+      const int lx = std::max(sx>>l,1), ly = std::max(sy>>l,1);
+      levelOffset.push_back(numTexels);
+      if (l > 0 || !sharedLevel0)
+        numTexels += tiledTexels(lx,ly);
+      if (lx == 1 && ly == 1) break;
+    }
+    return numTexels;
+  }
+
+  /*! builds the tiled mip pyramid of the N-channel image 'data',
+      without level 0 if that stays in the app's (shared) buffer */
+  template<typename T, int N>
+  void *buildMipPyramid(int sx, int sy, const void *data, bool sharedLevel0,
+                        std::vector<uint32> &levelOffset)
+  {
+    const size_t numTexels = levelOffsets(sx,sy,sharedLevel0,levelOffset);
+
+    // allocated as bytes, the way ~Texture2D frees it
+    T *tiled = (T*)new unsigned char[N*numTexels*sizeof(T)];
+    memset(tiled,0,N*numTexels*sizeof(T));
+
+    std::vector<T> level((const T*)data,(const T*)data+N*size_t(sx)*sy);
+    std::vector<T> next;
+    for (size_t l=0;l<levelOffset.size();l++) {
+      const int lx = std::max(sx>>l,1), ly = std::max(sy>>l,1);
+      if (l > 0 || !sharedLevel0)
+        tile<T,N>(&level[0],lx,ly,tiled+N*levelOffset[l]);
+      if (l+1 == levelOffset.size()) break;
+
+      const int nx = std::max(lx>>1,1), ny = std::max(ly>>1,1);
+      next.resize(N*size_t(nx)*ny);
+      downsample<T,N>(&level[0],lx,ly,&next[0],nx,ny);
+      level.swap(next);
+    }
+    return tiled;
+  }
+
+#if TEXEL_TILE_BITS != 2
+# error "compressed textures store one 4x4 block per texel tile"
+#endif
+
+  /*! expands 8-bit RGB or RGBA texels to RGBA for block compression;
+      the fourth channel of texture texels is transparency, which BC
+      alpha stores as opacity, and RGB texels are opaque */
+  std::vector<uint8> toRGBA(int sx, int sy, const uint8 *texels, int channels)
+  {
+    std::vector<uint8> rgba(4*size_t(sx)*sy,255);
+    for (size_t i=0;i<size_t(sx)*sy;i++) {
+      for (int c=0;c<3;c++)
+        rgba[4*i+c] = texels[channels*i+c];
+      if (channels == 4)
+        rgba[4*i+3] = 255 - texels[4*i+3];
+    }
+    return rgba;
+  }
+
+  /*! decodes a BC1 or BC3 image of (width+3)/4 x (height+3)/4 blocks
+      into RGBA texels */
+  std::vector<uint8> decodeBlocks(int sx, int sy, const uint8 *blocks, OSPDataType type)
+  {
+    std::vector<uint8> rgba(4*size_t(sx)*sy);
+    const int blocksX = (sx+3)/4, blocksY = (sy+3)/4;
+    uint8 texels[16*4];
+    for (int by=0;by<blocksY;by++)
+      for (int bx=0;bx<blocksX;bx++) {
+        const uint8 *block = blocks + (size_t(by)*blocksX+bx)*sizeOf(type);
+        if (type == OSP_BC1) decodeBC1(block,texels);
+        else decodeBC3(block,texels);
+        for (int t=0;t<16;t++) {
+          const int x = 4*bx+(t&3), y = 4*by+(t>>2);
+          if (x < sx && y < sy)
+            memcpy(&rgba[4*(size_t(y)*sx+x)],texels+4*t,4);
+        }
+      }
+    return rgba;
+  }
+
+  /*! builds the mip pyramid of a BC1 or BC3 texture from its RGBA
+      texels: each 4x4 block takes the place of one texel tile, so
+      level offsets stay in units of texels; level 0 uses the given
+      'blocks' as is if the data was compressed already, and is left
+      out if those blocks stay in the app's (shared) buffer */
+  void *buildCompressedMipPyramid(int sx, int sy, std::vector<uint8> &rgba,
+                                  const uint8 *blocks, OSPDataType type,
+                                  bool sharedLevel0,
+                                  std::vector<uint32> &levelOffset)
+  {
+    const size_t blockBytes = sizeOf(type);
+    const size_t numTexels = levelOffsets(sx,sy,sharedLevel0,levelOffset);
+    uint8 *compressed = new uint8[(numTexels >> 4)*blockBytes];
+
+    std::vector<uint8> next;
+    uint8 texels[16*4];
+    for (size_t l=0;l<levelOffset.size();l++) {
+      const int lx = std::max(sx>>l,1), ly = std::max(sy>>l,1);
+      const int blocksX = (lx+3)/4, blocksY = (ly+3)/4;
+      uint8 *dst = compressed + (levelOffset[l] >> 4)*blockBytes;
+      if (l == 0 && sharedLevel0) {
+        // level 0 stays in the app's buffer
+      } else if (l == 0 && blocks) {
+        memcpy(dst,blocks,size_t(blocksX)*blocksY*blockBytes);
+      } else {
+        for (int by=0;by<blocksY;by++)
+          for (int bx=0;bx<blocksX;bx++) {
+            // texels past the level's border repeat the last row/column
+            for (int t=0;t<16;t++) {
+              const int x = std::min(4*bx+(t&3),lx-1), y = std::min(4*by+(t>>2),ly-1);
+              memcpy(texels+4*t,&rgba[4*(size_t(y)*lx+x)],4);
+            }
+            uint8 *block = dst + (size_t(by)*blocksX+bx)*blockBytes;
+            if (type == OSP_BC1) encodeBC1(texels,block);
+            else encodeBC3(texels,block);
+          }
+      }
+      if (l+1 == levelOffset.size()) break;
+
+      const int nx = std::max(lx>>1,1), ny = std::max(ly>>1,1);
+      next.resize(4*size_t(nx)*ny);
+      downsample<uint8,4>(&rgba[0],lx,ly,&next[0],nx,ny);
+      rgba.swap(next);
+    }
+    return compressed;
+  }
+
+  size_t Texture2D::numBytes(int sx, int sy, OSPDataType type)
+  {
+    if (type == OSP_BC1 || type == OSP_BC3)
+      return sizeOf(type) * ((sx+3)/4) * ((sy+3)/4);
+    return sizeOf(type) * sx * sy;
+  }
+
+  Texture2D::~Texture2D()
+  {
+    if (ispcEquivalent)
+      ispc::Texture2D_destroy(ispcEquivalent);
+    // the mip levels this texture created; a shared level 0 stays
+    // owned by the app
+    delete[] (unsigned char*)data;
+  }
+
   Texture2D *Texture2D::createTexture(int sx, int sy, OSPDataType type, void *data, int flags) 
   {
     Texture2D *tx = new Texture2D;
+    tx->data = NULL;
     
-    //NOTE: For now, we just copy the data and rely on the viewer to have logic for buffer sharing.
-    int bpp = 0;
-    //TODO:ISPC side memory for images isn't currently managed, this will leak!
-    void *img = NULL;
+    assert(data);
+
+    /* the texels get re-laid out into a tiled mip pyramid; with
+       OSP_DATA_SHARED_BUFFER level 0 is read from the app's buffer
+       instead (as is for BC1/BC3 blocks, which already are in tile
+       order), unless the texels have to be compressed first */
+    const bool shared = (flags & OSP_DATA_SHARED_BUFFER) && !(flags & OSP_TEXTURE_COMPRESS);
+    void *level0 = shared ? data : NULL;
+    std::vector<uint32> levelOffset;
+    if (flags & OSP_TEXTURE_COMPRESS) {
+      if (type == OSP_UCHAR3) {
+        std::vector<uint8> rgba = toRGBA(sx,sy,(const uint8*)data,3);
+        tx->data = buildCompressedMipPyramid(sx,sy,rgba,NULL,OSP_BC1,false,levelOffset);
+        type = OSP_BC1;
+      } else if (type == OSP_UCHAR4) {
+        std::vector<uint8> rgba = toRGBA(sx,sy,(const uint8*)data,4);
+        tx->data = buildCompressedMipPyramid(sx,sy,rgba,NULL,OSP_BC3,false,levelOffset);
+        type = OSP_BC3;
+      }
+    } else if (type == OSP_BC1 || type == OSP_BC3) {
+      std::vector<uint8> rgba = decodeBlocks(sx,sy,(const uint8*)data,type);
+      tx->data = buildCompressedMipPyramid(sx,sy,rgba,(const uint8*)data,type,shared,levelOffset);
+    }
+
     switch (type) {
     case OSP_UCHAR4:
-      tx->ispcEquivalent = ispc::Texture2D_4uc_create(tx,sx,sy,data);
-      bpp = 4;
+      tx->data = buildMipPyramid<unsigned char,4>(sx,sy,data,shared,levelOffset);
+      tx->ispcEquivalent = ispc::Texture2D_4uc_create(tx,sx,sy,tx->data,
+                                                      levelOffset.size(),&levelOffset[0],
+                                                      level0,false);
       break;
     case OSP_UCHAR3:
-      tx->ispcEquivalent = ispc::Texture2D_3uc_create(tx,sx,sy,data);
-      bpp = 3;
+      tx->data = buildMipPyramid<unsigned char,3>(sx,sy,data,shared,levelOffset);
+      tx->ispcEquivalent = ispc::Texture2D_3uc_create(tx,sx,sy,tx->data,
+                                                      levelOffset.size(),&levelOffset[0],
+                                                      level0,false);
       break;
     case OSP_FLOAT3:
-      tx->ispcEquivalent = ispc::Texture2D_3f_create(tx,sx,sy,data);
-      bpp = 3 * sizeof(float);
+      tx->data = buildMipPyramid<float,3>(sx,sy,data,shared,levelOffset);
+      tx->ispcEquivalent = ispc::Texture2D_3f_create(tx,sx,sy,tx->data,
+                                                     levelOffset.size(),&levelOffset[0],
+                                                     level0,false);
       break;
     case OSP_FLOAT3A:
-      tx->ispcEquivalent = ispc::Texture2D_4f_create(tx,sx,sy,data);
-      bpp = 4 * sizeof(float);
+      tx->data = buildMipPyramid<float,4>(sx,sy,data,shared,levelOffset);
+      tx->ispcEquivalent = ispc::Texture2D_4f_create(tx,sx,sy,tx->data,
+                                                     levelOffset.size(),&levelOffset[0],
+                                                     level0,false);
       break;
-    default: throw std::runtime_error("Could not determine bytes per pixel in " __FILE__);
+    case OSP_BC1:
+      tx->ispcEquivalent = ispc::Texture2D_BC1_create(tx,sx,sy,tx->data,
+                                                      levelOffset.size(),&levelOffset[0],
+                                                      level0,true);
+      break;
+    case OSP_BC3:
+      tx->ispcEquivalent = ispc::Texture2D_BC3_create(tx,sx,sy,tx->data,
+                                                      levelOffset.size(),&levelOffset[0],
+                                                      level0,true);
+      break;
+    default:
+      delete tx;
+      throw std::runtime_error("Could not determine bytes per pixel in " __FILE__);
     }
 
     assert(tx->ispcEquivalent && "ispcEquivalent may not be null in Texture2D");
     
-    const int bytes = sx * sy * bpp;
     tx->width = sx;
     tx->height = sy;
     tx->type = type;
-    
-    assert(data);
-    
-    //Do we really need to make this copy?
-    if (flags & OSP_DATA_SHARED_BUFFER) {
-      tx->data = data;
-    } else {
-      tx->data = bytes ? new unsigned char[bytes] : NULL;
-      memcpy(tx->data, data, bytes);
-    }
+    tx->numLevels = levelOffset.size();
     
     tx->managedObjectType = OSP_TEXTURE;
     return tx;
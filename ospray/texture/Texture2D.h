@@ -27,14 +27,21 @@ namespace ospray {
     /*! Every derived class should overrride this! */
     virtual std::string toString() const { return "ospray::Texture2D"; }
 
+    /*! \brief frees the mip levels and the ISPC-side level table */
+    virtual ~Texture2D();
+
     /*! \brief creates a Texture2D object with the given parameter */
     static Texture2D *createTexture(int width, int height, OSPDataType type, 
                                     void *data, int flags);
+    /*! \brief size in bytes of a width x height image of the given type
+        (for OSP_BC1/OSP_BC3: of its (width+3)/4 x (height+3)/4 blocks) */
+    static size_t numBytes(int width, int height, OSPDataType type);
 
     int width;
     int height;
     OSPDataType type;
-    void *data;
+    void *data;      //!< texels of all mip levels but a shared level 0, tiled (see texelTileSize.h)
+    int numLevels;   //!< number of mip levels, down to 1x1
   };
 
 } // ::ospray
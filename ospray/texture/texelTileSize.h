@@ -0,0 +1,24 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+/*! Texture2D stores the texels of each mip level in square tiles of
+    TEXEL_TILE_SIZE x TEXEL_TILE_SIZE texels (row-major within a tile,
+    tiles row-major within the level), such that the four texels of a
+    bilinear lookup usually share a cache line. Included from both
+    C++ and ISPC. */
+#define TEXEL_TILE_BITS 2
+#define TEXEL_TILE_SIZE (1<<TEXEL_TILE_BITS)
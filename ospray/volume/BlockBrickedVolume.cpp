@@ -16,12 +16,36 @@
 
 //ospray
 #include "ospray/volume/BlockBrickedVolume.h"
+#include "ospray/common/Memory.h"
+#include "ospray/common/NUMA.h"
 #include "BlockBrickedVolume_ispc.h"
 // std
 #include <cassert>
 
+//! Called from ISPC: storage for all voxel blocks of a volume, NULL if out of memory.
+extern "C" void *BlockBrickedVolume_allocBlocks(ospray::uint64 numBytes)
+{
+  //! Rays sample the blocks in no particular order, so spread them across the NUMA nodes rather than placing them on one.
+  try {
+    return ospray::numaAware ? ospray::numa::allocInterleaved(numBytes) : ospray::allocLarge(numBytes);
+  } catch (const std::exception &) {
+    return NULL;
+  }
+}
+
+//! Called from ISPC: free the storage from BlockBrickedVolume_allocBlocks().
+extern "C" void BlockBrickedVolume_freeBlocks(void *ptr)
+{
+  ospray::freeLarge(ptr);
+}
+
 namespace ospray {
 
+  BlockBrickedVolume::~BlockBrickedVolume()
+  {
+    if (ispcEquivalent != NULL) ispc::BlockBrickedVolume_freeVoxelData(ispcEquivalent);
+  }
+
   void BlockBrickedVolume::commit()
   {
     //! The ISPC volume container should already exist.
@@ -36,11 +60,8 @@ namespace ospray {
     //! Create the equivalent ISPC volume container and allocate memory for voxel data.
     if (ispcEquivalent == NULL) createEquivalentISPC();
 
-    //! Compute the voxel value range for float voxels if none was previously specified.
-    if (voxelType == "float" && findParam("voxelRange") == NULL) computeVoxelRange((float *) source, size_t(count.x) * count.y * count.z);
-
-    //! Compute the voxel value range for unsigned byte voxels if none was previously specified.
-    if (voxelType == "uchar" && findParam("voxelRange") == NULL) computeVoxelRange((unsigned char *) source, size_t(count.x) * count.y * count.z);
+    //! Compute the voxel value range if none was previously specified.
+    if (findParam("voxelRange") == NULL) computeVoxelRange(source, size_t(count.x) * count.y * count.z);
 
     //! Copy voxel data into the volume.
     ispc::BlockBrickedVolume_setRegion(ispcEquivalent, source, (const ispc::vec3i &) index, (const ispc::vec3i &) count);
@@ -59,8 +80,11 @@ namespace ospray {
     vec3i dimensions = getParam3i("dimensions", vec3i(0));
     exitOnCondition(reduce_min(dimensions) <= 0, "invalid volume dimensions (must be set before calling ospSetRegion())");
 
+    //! Optionally store a one voxel halo per brick (must be set before calling ospSetRegion()).
+    bool ghostVoxels = getParam1i("ghostVoxels", 0) != 0;
+
     //! Create an ISPC BlockBrickedVolume object and assign type-specific function pointers.
-    ispcEquivalent = ispc::BlockBrickedVolume_createInstance((int)getVoxelType(), (const ispc::vec3i &)dimensions);
+    ispcEquivalent = ispc::BlockBrickedVolume_createInstance((int)getVoxelType(), (const ispc::vec3i &)dimensions, ghostVoxels);
   }
 
 } // ::ospray
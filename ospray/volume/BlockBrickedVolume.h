@@ -24,14 +24,20 @@ namespace ospray {
   //!  with 62-bit addressing in which the voxel data is laid out in
   //!  memory in multiple pages each in brick order.
   //!
+  //!  If the integer parameter "ghostVoxels" is non-zero when the
+  //!  first region is set, each brick additionally stores a one voxel
+  //!  halo copied from its neighbors during setRegion. This costs
+  //!  about 42% more memory, but every trilinear sample can then be
+  //!  served from a single brick.
+  //!
   class BlockBrickedVolume : public StructuredVolume {
   public:
 
     //! Constructor.
     BlockBrickedVolume() {};
 
-    //! Destructor.
-    virtual ~BlockBrickedVolume() {};
+    //! Destructor, frees the voxel data.
+    virtual ~BlockBrickedVolume();
 
     //! A string description of this class.
     virtual std::string toString() const { return("ospray::BlockBrickedVolume<" + voxelType + ">"); }
@@ -0,0 +1,86 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+//ospray
+#include "ospray/volume/CompressedBrickedVolume.h"
+#include "CompressedBrickedVolume_ispc.h"
+// std
+#include <cassert>
+
+namespace ospray {
+
+  CompressedBrickedVolume::~CompressedBrickedVolume()
+  {
+    if (ispcEquivalent != NULL) ispc::CompressedBrickedVolume_freeBricks(ispcEquivalent);
+  }
+
+  void CompressedBrickedVolume::commit()
+  {
+    //! The ISPC volume container should already exist.
+    exitOnCondition(ispcEquivalent == NULL, "the volume data must be set via ospSetRegion() prior to commit for this volume type");
+
+    //! Encode the bricks not completely set so far (only on first commit).
+    if (!finished) {
+      ispc::CompressedBrickedVolume_encodeStagedBricks(ispcEquivalent);
+
+      vec3i dimensions = getParam3i("dimensions", vec3i(0));
+      size_t encodedSize = ispc::CompressedBrickedVolume_getEncodedSize(ispcEquivalent);
+      size_t decodedSize = size_t(dimensions.x) * dimensions.y * dimensions.z * sizeOf(getVoxelType());
+      if (logLevel >= 1)
+        std::cout << "#osp: compressed volume from " << decodedSize << " to " << encodedSize << " bytes" << std::endl;
+    }
+
+    //! StructuredVolume commit actions.
+    StructuredVolume::commit();
+  }
+
+  int CompressedBrickedVolume::setRegion(const void *source, const vec3i &index, const vec3i &count)
+  {
+    //! Create the equivalent ISPC volume container.
+    if (ispcEquivalent == NULL) createEquivalentISPC();
+
+    //! The region must lie inside the volume.
+    vec3i dimensions = getParam3i("dimensions", vec3i(0));
+    if (reduce_min(count) <= 0 || reduce_min(index) < 0 || reduce_max(index + count - dimensions) > 0) return false;
+
+    //! Copy voxel data into the volume, fails if the region overlaps bricks which were already encoded.
+    if (!ispc::CompressedBrickedVolume_setRegion(ispcEquivalent, source, (const ispc::vec3i &) index, (const ispc::vec3i &) count)) return false;
+
+    //! Compute the voxel value range if none was previously specified.
+    if (findParam("voxelRange") == NULL) computeVoxelRange(source, size_t(count.x) * count.y * count.z);
+
+    return true;
+  }
+
+  void CompressedBrickedVolume::createEquivalentISPC() 
+  {
+    //! Get the voxel type.
+    voxelType = getParamString("voxelType", "unspecified");  
+    exitOnCondition(getVoxelType() == OSP_UNKNOWN, "unrecognized voxel type (must be set before calling ospSetRegion())");
+
+    //! Get the volume dimensions.
+    vec3i dimensions = getParam3i("dimensions", vec3i(0));
+    exitOnCondition(reduce_min(dimensions) <= 0, "invalid volume dimensions (must be set before calling ospSetRegion())");
+
+    //! Get the compression mode (must be set before calling ospSetRegion()).
+    std::string compression = getParamString("compression", "lossless");
+    exitOnCondition(compression != "lossless" && compression != "lossy", "unrecognized compression mode '" + compression + "'");
+
+    //! Create an ISPC CompressedBrickedVolume object and assign type-specific function pointers.
+    ispcEquivalent = ispc::CompressedBrickedVolume_createInstance((int)getVoxelType(), (const ispc::vec3i &)dimensions, compression == "lossy");
+  }
+
+} // ::ospray
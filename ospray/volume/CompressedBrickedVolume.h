@@ -0,0 +1,64 @@
+// ======================================================================== //
+// Copyright 2009-2015 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "ospray/volume/StructuredVolume.h"
+
+namespace ospray {
+
+  //! \brief A concrete implementation of the StructuredVolume class
+  //!  in which the voxel data is stored in 16^3 voxel bricks, each
+  //!  encoded with a per-brick codec and decoded while sampling.
+  //!
+  //!  Bricks of constant value are stored as that value only, and
+  //!  bricks of 16-bit integer voxels spanning at most 256 consecutive
+  //!  values as 8-bit offsets. If the string parameter "compression"
+  //!  is "lossy", all other bricks are quantized to 8 bits between
+  //!  their minimum and maximum value, otherwise they are stored in the
+  //!  native voxel type. A brick is encoded as soon as all its voxels
+  //!  have been set via setRegion, so each voxel can be set only once;
+  //!  the remaining bricks are encoded on the first commit. The value
+  //!  ranges of the space skipping grid are computed from the decoded
+  //!  voxels and thus stay exact.
+  //!
+  class CompressedBrickedVolume : public StructuredVolume {
+  public:
+
+    //! Constructor.
+    CompressedBrickedVolume() {};
+
+    //! Destructor, frees the encoded bricks.
+    virtual ~CompressedBrickedVolume();
+
+    //! A string description of this class.
+    virtual std::string toString() const { return("ospray::CompressedBrickedVolume<" + voxelType + ">"); }
+
+    //! Encode the remaining bricks and complete the volume, called through the OSPRay API.
+    virtual void commit();
+
+    //! Copy voxels into the volume at the given index (non-zero return value indicates success).
+    virtual int setRegion(const void *source, const vec3i &index, const vec3i &count);
+
+  protected:
+
+    //! Create the equivalent ISPC volume container.
+    virtual void createEquivalentISPC();
+
+  };
+
+} // ::ospray
+
@@ -43,7 +43,7 @@ namespace ospray {
     exitOnCondition(reduce_min(dimensions) <= 0, "invalid volume dimensions");
 
     //! This volume type only supports 2GB volumes for now.
-    size_t voxelSize = getVoxelType() == OSP_FLOAT ? 4 : 1;
+    size_t voxelSize = sizeOf(getVoxelType());
     exitOnCondition(dimensions.x*dimensions.y*dimensions.z*voxelSize > (1L << 31), "this volume type currently only supports up to 2GB volumes");
 
     //! Get the voxel data.
@@ -54,11 +54,8 @@ namespace ospray {
     //! The voxel count.
     size_t voxelCount = (size_t)dimensions.x * dimensions.y * dimensions.z;
   
-    //! Compute the voxel value range for float voxels if none was previously specified.
-    if (voxelType == "float" && findParam("voxelRange") == NULL) computeVoxelRange((float *)voxelData->data, voxelCount);
-
-    //! Compute the voxel value range for unsigned byte voxels if none was previously specified.
-    if (voxelType == "uchar" && findParam("voxelRange") == NULL) computeVoxelRange((unsigned char *)voxelData->data, voxelCount);
+    //! Compute the voxel value range if none was previously specified.
+    if (findParam("voxelRange") == NULL) computeVoxelRange(voxelData->data, voxelCount);
 
     //! Create an ISPC SharedStructuredVolume object and assign type-specific function pointers.
     ispcEquivalent = ispc::SharedStructuredVolume_createInstance((int)getVoxelType(), (const ispc::vec3i &)dimensions, voxelData->data);
@@ -24,6 +24,15 @@
 
 namespace ospray {
 
+  StructuredVolume::~StructuredVolume()
+  {
+    //! The ISPC volume container itself is freed by the ManagedObject destructor.
+    if (ispcEquivalent != NULL) ispc::StructuredVolume_freeAccelerator(ispcEquivalent);
+
+    //! Free the precomputed gradient field, if any.
+    if (ispcEquivalent != NULL) ispc::StructuredVolume_setPrecomputedGradients(ispcEquivalent, false);
+  }
+
   void StructuredVolume::commit()
   {
     //! Some parameters can be changed after the volume has been allocated and filled.
@@ -42,6 +51,11 @@ namespace ospray {
       finish();
       finished = true;
     }
+
+    //! Optionally trade 2 bytes per voxel for not computing gradients from the voxels on every shaded sample.  Like the
+    //! space skipping grid, the gradient field reflects the voxels present when it is built (on the first commit with
+    //! the parameter set).
+    ispc::StructuredVolume_setPrecomputedGradients(ispcEquivalent, getParam1i("precomputedGradients", 0));
   }
 
   void StructuredVolume::finish()
@@ -70,9 +84,55 @@ namespace ospray {
     //! Unsigned 8-bit scalar integer.
     if (!strcmp(kind, "uchar") && width == 1) return(OSP_UCHAR);
 
+    //! Unsigned 16-bit scalar integer.
+    if (!strcmp(kind, "ushort") && width == 1) return(OSP_USHORT);
+
+    //! Signed 16-bit scalar integer.
+    if (!strcmp(kind, "short") && width == 1) return(OSP_SHORT);
+
+    //! Half precision scalar floating point.
+    if (!strcmp(kind, "half") && width == 1) return(OSP_HALF);
+
     //! Unknown voxel type.
     return OSP_UNKNOWN;
   }
 
+  //! Convert an IEEE 754 half precision value to single precision.
+  static inline float halfToFloat(const uint16 h)
+  {
+    const uint32 sign = uint32(h & 0x8000) << 16;
+    const uint32 exponent = (h >> 10) & 0x1f;
+    const uint32 mantissa = h & 0x3ff;
+    union { uint32 u; float f; } result;
+
+    if (exponent == 0x1f)   //! Infinity or NaN.
+      result.u = sign | 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0) //! Normalized value.
+      result.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else {                  //! Zero or denormalized value.
+      result.f = mantissa * (1.0f / (1 << 24));
+      result.u |= sign;
+    }
+    return result.f;
+  }
+
+  void StructuredVolume::computeVoxelRange(const void *source, const size_t &count)
+  {
+    switch (getVoxelType()) {
+    case OSP_FLOAT:  computeVoxelRange((const float *) source, count);  break;
+    case OSP_UCHAR:  computeVoxelRange((const uint8 *) source, count);  break;
+    case OSP_USHORT: computeVoxelRange((const uint16 *) source, count);  break;
+    case OSP_SHORT:  computeVoxelRange((const int16 *) source, count);  break;
+    case OSP_HALF:
+      for (size_t i=0 ; i < count ; i++) {
+        const float value = halfToFloat(((const uint16 *) source)[i]);
+        voxelRange.x = std::min(voxelRange.x, value), voxelRange.y = std::max(voxelRange.y, value);
+      }
+      break;
+    default:
+      exitOnCondition(true, "unsupported voxel type '" + voxelType + "'");
+    }
+  }
+
 } // ::ospray
 
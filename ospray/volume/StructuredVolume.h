@@ -38,8 +38,8 @@ namespace ospray {
     //! Constructor.
     StructuredVolume() : finished(false), voxelRange(FLT_MAX, -FLT_MAX) {}
 
-    //! Destructor.
-    virtual ~StructuredVolume() {};
+    //! Destructor, frees the space skipping grid and the precomputed gradient field.
+    virtual ~StructuredVolume();
 
     //! A string description of this class.
     virtual std::string toString() const { return("ospray::StructuredVolume<" + voxelType + ">"); }
@@ -70,14 +70,14 @@ namespace ospray {
     //! Get the OSPDataType enum corresponding to the voxel type string.
     OSPDataType getVoxelType() const;
 
-    //! Compute the voxel value range for floating point voxels.
-    inline void computeVoxelRange(const float *source, const size_t &count)
-      { for (size_t i=0 ; i < count ; i++) voxelRange.x = std::min(voxelRange.x, source[i]), voxelRange.y = std::max(voxelRange.y, source[i]); }
-
-    //! Compute the voxel value range for unsigned byte voxels.
-    inline void computeVoxelRange(const unsigned char *source, const size_t &count)
+    //! Compute the voxel value range for voxels of a native scalar type.
+    template<typename T>
+    inline void computeVoxelRange(const T *source, const size_t &count)
       { for (size_t i=0 ; i < count ; i++) voxelRange.x = std::min(voxelRange.x, (float) source[i]), voxelRange.y = std::max(voxelRange.y, (float) source[i]); }
 
+    //! Compute the voxel value range for voxels of the type given by the voxel type string.
+    void computeVoxelRange(const void *source, const size_t &count);
+
   };
 
 } // ::ospray
@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "ospray/volume/BlockBrickedVolume.h"
+#include "ospray/volume/CompressedBrickedVolume.h"
 #include "ospray/volume/SharedStructuredVolume.h"
 
 namespace ospray {
@@ -22,6 +23,9 @@ namespace ospray {
   //! A volume type with 64-bit addressing and multi-level bricked storage order.
   OSP_REGISTER_VOLUME(BlockBrickedVolume, block_bricked_volume);
 
+  //! A volume type storing each brick of voxels with a per-brick codec to reduce memory consumption.
+  OSP_REGISTER_VOLUME(CompressedBrickedVolume, compressed_bricked_volume);
+
   //! A volume type with 32-bit addressing and XYZ storage order. The voxel data is provided by the application via a shared data buffer.
   OSP_REGISTER_VOLUME(SharedStructuredVolume, shared_structured_volume);
 